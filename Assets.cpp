@@ -0,0 +1,99 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Assets.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+
+/*
+===================
+Assets::Prefetch
+
+Reads the files behind the given paths on worker threads, so the engine finds them
+in the system file cache when it loads them on the main thread. The engine uploads
+resources to the GPU while decoding them, so decoding itself stays on the main thread.
+===================
+*/
+void Assets::Prefetch(const std::vector<libStr> &paths)
+{
+    WaitPrefetch();
+
+    auto files = std::make_shared<std::vector<std::string>>();
+
+    for (const libStr &path : paths)
+    {
+        std::string file = path.Get();
+
+        // Files inside a data pack are read through the pack itself
+        size_t pack = file.find("//");
+
+        if (pack != std::string::npos)
+            file.resize(pack);
+
+        if (std::find(files->begin(), files->end(), file) == files->end())
+            files->push_back(file);
+    }
+
+    auto next = std::make_shared<std::atomic<size_t>>(0);
+    size_t threads = std::min<size_t>(files->size(), std::max(1u, std::thread::hardware_concurrency()));
+
+    for (size_t i = 0; i < threads; i++)
+    {
+        prefetchThreads.emplace_back([files, next]()
+        {
+            for (size_t j = (*next)++; j < files->size(); j = (*next)++)
+                PrefetchFile((*files)[j]);
+        });
+    }
+}
+
+/*
+===================
+Assets::WaitPrefetch
+===================
+*/
+void Assets::WaitPrefetch()
+{
+    for (std::thread &thread : prefetchThreads)
+        thread.join();
+
+    prefetchThreads.clear();
+}
+
+/*
+===================
+Assets::PrefetchFile
+===================
+*/
+void Assets::PrefetchFile(const std::string &file)
+{
+    FILE *f = fopen(file.c_str(), "rb");
+
+    if (!f)
+        return;
+
+    char buffer[64 * 1024];
+
+    while (fread(buffer, 1, sizeof(buffer), f) == sizeof(buffer));
+
+    fclose(f);
+}
@@ -0,0 +1,128 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Main.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/*
+===========================================================
+
+    Assets
+
+    Keeps every loaded resource keyed by its path, so a file requested
+    from several places is decoded only once.
+
+===========================================================
+*/
+class Assets
+{
+public:
+
+                        Assets() = default;
+                        ~Assets() { WaitPrefetch(); }
+
+    template<typename type_t>
+    bool                Get(libPtr<type_t> &asset, const char *path);
+
+    void                Prefetch(const std::vector<libStr> &paths);
+    void                WaitPrefetch();
+
+    int                 Loads() const { return loads; }
+    int                 Hits() const { return hits; }
+    float               LoadTime() const { return loadTime; }
+
+private:
+
+    template<typename type_t>
+    std::unordered_map<std::string, libPtr<type_t>> &Cache();
+
+    static void         PrefetchFile(const std::string &file);
+
+    std::unordered_map<std::string, libPtr<libTexture>> textures;
+    std::unordered_map<std::string, libPtr<libSprite>> sprites;
+    std::unordered_map<std::string, libPtr<libFont>> fonts;
+    std::unordered_map<std::string, libPtr<libSound>> sounds;
+
+    std::vector<std::thread> prefetchThreads;
+
+    int                 loads = 0;
+    int                 hits = 0;
+    float               loadTime = 0.0f;
+};
+
+/*
+===================
+Assets::Get
+
+Returns a cached resource or loads it on the first request.
+===================
+*/
+template<typename type_t>
+bool Assets::Get(libPtr<type_t> &asset, const char *path)
+{
+    auto &cache = Cache<type_t>();
+    auto it = cache.find(path);
+
+    if (it != cache.end())
+    {
+        asset = it->second;
+        hits++;
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!engine->Get(asset.Get(), path))
+        return false;
+
+    loadTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    loads++;
+
+    cache.emplace(path, asset);
+    return true;
+}
+
+/*
+===================
+Assets::Cache
+===================
+*/
+template<typename type_t>
+std::unordered_map<std::string, libPtr<type_t>> &Assets::Cache()
+{
+    if constexpr (std::is_same_v<type_t, libTexture>)
+        return textures;
+    else if constexpr (std::is_same_v<type_t, libSprite>)
+        return sprites;
+    else if constexpr (std::is_same_v<type_t, libFont>)
+        return fonts;
+    else
+    {
+        static_assert(std::is_same_v<type_t, libSound>, "Unsupported asset type");
+        return sounds;
+    }
+}
@@ -0,0 +1,131 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "AutoDifficulty.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+===================
+AutoDifficulty::Record
+===================
+*/
+void AutoDifficulty::Record(const game_t &game)
+{
+    // Skill, one step of Bayesian logistic regression with a Gaussian belief
+    float logit = belief.skill - Difficulty(game.width, game.height, static_cast<float>(game.mines) / (game.width * game.height));
+    float predicted = 1.0f / (1.0f + std::exp(-logit));
+
+    belief.skillVariance += AUTO_SKILL_DRIFT;
+    belief.skillVariance = 1.0f / (1.0f / belief.skillVariance + predicted * (1.0f - predicted));
+    belief.skill += belief.skillVariance * ((game.won ? 1.0f : 0.0f) - predicted);
+
+    // Speed, from games that went on long enough to say anything
+    int safeTiles = game.width * game.height - game.mines;
+
+    belief.speedVariance += AUTO_SPEED_DRIFT;
+
+    if (game.seconds >= 1.0f && game.openedTiles >= safeTiles / 10 && game.openedTiles > 0)
+    {
+        float mineRatio = static_cast<float>(game.mines) / (game.width * game.height);
+        float observed = std::log(game.seconds / game.openedTiles) - AUTO_TIME_RATIO_SLOPE * (mineRatio - DEFAULT_MINE_RATIO);
+        float gain = belief.speedVariance / (belief.speedVariance + AUTO_SPEED_NOISE);
+
+        belief.speed += gain * (observed - belief.speed);
+        belief.speedVariance *= 1.0f - gain;
+    }
+}
+
+/*
+===================
+AutoDifficulty::Next
+
+Searches fields with the default proportions and every mine ratio in steps.
+===================
+*/
+void AutoDifficulty::Next(int &width, int &height, float &mineRatio) const
+{
+    float targetLogit = std::log(targetWinRate / (1.0f - targetWinRate));
+    float bestCost = HUGE_VALF;
+    int bestWidth = width, bestHeight = height;
+    float bestRatio = mineRatio;
+
+    for (int h = MINIMAL_FIELD_HEIGHT; h <= MAXIMAL_FIELD_HEIGHT; h++)
+    {
+        int w = static_cast<int>(std::lround(static_cast<float>(h) * DEFAULT_AUTO_FIELD_WIDTH / DEFAULT_AUTO_FIELD_HEIGHT));
+        w = std::clamp(w, MINIMAL_FIELD_WIDTH, MAXIMAL_FIELD_WIDTH);
+
+        for (float ratio = MINIMAL_MINE_RATIO; ratio <= MAXIMAL_MINE_RATIO + AUTO_MINE_RATIO_STEP / 2.0f; ratio += AUTO_MINE_RATIO_STEP)
+        {
+            float logit = belief.skill - Difficulty(w, h, ratio);
+            float duration = std::log(ExpectedSeconds(w, h, ratio) / targetSeconds);
+            float cost = (logit - targetLogit) * (logit - targetLogit) + AUTO_DURATION_WEIGHT * duration * duration +
+                         AUTO_SIZE_CHANGE_COST * std::abs(h - height);
+
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestWidth = w;
+                bestHeight = h;
+                bestRatio = ratio;
+            }
+        }
+    }
+
+    width = bestWidth;
+    height = bestHeight;
+    mineRatio = bestRatio;
+}
+
+/*
+===================
+AutoDifficulty::WinProbability
+===================
+*/
+float AutoDifficulty::WinProbability(int width, int height, float mineRatio) const
+{
+    return 1.0f / (1.0f + std::exp(Difficulty(width, height, mineRatio) - belief.skill));
+}
+
+/*
+===================
+AutoDifficulty::ExpectedSeconds
+
+For a game that is won, when every safe tile gets opened.
+===================
+*/
+float AutoDifficulty::ExpectedSeconds(int width, int height, float mineRatio) const
+{
+    float safeTiles = width * height * (1.0f - mineRatio);
+    return std::exp(belief.speed + AUTO_TIME_RATIO_SLOPE * (mineRatio - DEFAULT_MINE_RATIO)) * safeTiles;
+}
+
+/*
+===================
+AutoDifficulty::Difficulty
+
+Log-odds a player loses by, compared with the default field.
+===================
+*/
+float AutoDifficulty::Difficulty(int width, int height, float mineRatio) const
+{
+    float size = std::log(static_cast<float>(width * height) / (DEFAULT_AUTO_FIELD_WIDTH * DEFAULT_AUTO_FIELD_HEIGHT));
+    return AUTO_RATIO_SLOPE * (mineRatio - DEFAULT_MINE_RATIO) + AUTO_SIZE_SLOPE * size;
+}
@@ -0,0 +1,113 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Board.h"
+
+// Auto difficulty constants
+#define PREFERRED_GAME_DURATION     300     // Seconds a won game should take
+#define AUTO_TARGET_WIN_RATE        0.25f   // Where the old heuristic settled, so players keep the odds they're used to
+#define DEFAULT_MINE_RATIO          0.15f
+#define DEFAULT_AUTO_FIELD_WIDTH    25
+#define DEFAULT_AUTO_FIELD_HEIGHT   22
+#define MINIMAL_MINE_RATIO          0.05f
+#define MAXIMAL_MINE_RATIO          0.25f
+#define AUTO_MINE_RATIO_STEP        0.0025f // Resolution of the search
+
+// The model, fitted by MinefieldAutoDifficulty to games of bots that blunder like players do.
+// Win chances are logistic in the mine ratio and the log of the field size, relative to the default field.
+#define AUTO_RATIO_SLOPE            28.2f
+#define AUTO_SIZE_SLOPE             1.15f
+#define AUTO_TIME_RATIO_SLOPE       14.9f   // Change in the log of seconds per tile with the mine ratio
+
+// What is believed about a new player, and how fast it may change
+#define AUTO_SKILL_PRIOR            0.0f    // Log-odds of winning on the default field
+#define AUTO_SKILL_VARIANCE         2.0f
+#define AUTO_SKILL_DRIFT            0.002f  // Added to the variance every game, so old games weigh less
+#define AUTO_SPEED_PRIOR            -0.63f  // Log of seconds per opened tile on the default field
+#define AUTO_SPEED_VARIANCE         0.36f
+#define AUTO_SPEED_NOISE            0.09f   // Variance of a single game's speed around the player's
+#define AUTO_SPEED_DRIFT            0.002f
+
+// How the next field is chosen
+#define AUTO_DURATION_WEIGHT        0.5f    // Missing the duration by a factor of e counts as much as missing the win rate by half a log-odds
+#define AUTO_SIZE_CHANGE_COST       0.002f  // Per row, so the field doesn't jump around for tiny gains
+
+/*
+===========================================================
+
+    AutoDifficulty
+
+    Picks the field for the Auto difficulty from a model of the player.
+    The chance of winning is logistic in the mine ratio and the field
+    size, and the time a game takes is proportional to its safe tiles.
+    How the two depend on the field is fitted offline, only the player's
+    skill and speed are learned from their games.
+
+    Both are Gaussian beliefs updated after every game: skill by an
+    online logistic update, speed by a Kalman step. A new player starts
+    uncertain, so the first games move the field a lot and later ones
+    only a little, and the drift keeps following a player who improves.
+
+    The next field is the one whose predicted win rate and duration
+    come closest to the targets.
+
+===========================================================
+*/
+class AutoDifficulty
+{
+public:
+
+    struct game_t
+    {
+        int             width = 0;
+        int             height = 0;
+        int             mines = 0;
+        bool            won = false;
+        float           seconds = 0.0f;
+        int             openedTiles = 0;    // Safe tiles opened, by the player or by openings
+    };
+
+    // Persistent state of the player
+    struct belief_t
+    {
+        float           skill = AUTO_SKILL_PRIOR;
+        float           skillVariance = AUTO_SKILL_VARIANCE;
+        float           speed = AUTO_SPEED_PRIOR;
+        float           speedVariance = AUTO_SPEED_VARIANCE;
+    };
+
+    void                Record(const game_t &game);
+
+    // Takes the current field and returns the next one
+    void                Next(int &width, int &height, float &mineRatio) const;
+
+    float               WinProbability(int width, int height, float mineRatio) const;
+    float               ExpectedSeconds(int width, int height, float mineRatio) const;
+
+    belief_t            belief;
+
+    float               targetWinRate = AUTO_TARGET_WIN_RATE;
+    float               targetSeconds = PREFERRED_GAME_DURATION;
+
+private:
+
+    float               Difficulty(int width, int height, float mineRatio) const;
+};
@@ -0,0 +1,376 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Board.h"
+
+/*
+===================
+Board::Reset
+===================
+*/
+void Board::Reset(int width, int height, int mines)
+{
+    this->width = width;
+    this->height = height;
+
+    if (mines >= width * height)
+        mines = width * height - 1;
+
+    this->mines = mines;
+    minesLeft = mines;
+    shownMinesLeft = mines;
+    closedSafe = width * height;
+    exploded = -1;
+    state = PLAYING;
+    generated = false;
+    generation++;
+
+    tiles.assign(width * height, Tile());
+    changes.clear();
+}
+
+/*
+===================
+Board::PlaceMines
+
+Also calculates the number of nearest mines for each tile.
+===================
+*/
+void Board::PlaceMines(const std::vector<int> &mined)
+{
+    for (int index : mined)
+    {
+        tiles[index].type = Tile::MINED;
+        int x = X(index), y = Y(index);
+
+        for (int j = y - 1; j <= y + 1; j++)
+            for (int i = x - 1; i <= x + 1; i++)
+                if (IsInside(i, j))
+                    tiles[Index(i, j)].nearestMines++;
+    }
+
+    // Mines don't count themselves, but it's simpler to undo it afterwards
+    for (int index : mined)
+        tiles[index].nearestMines--;
+
+    for (Tile &tile : tiles)
+        if (tile.type == Tile::MINED)
+            tile.nearestMines = 0;
+
+    mines = static_cast<int>(mined.size());
+    minesLeft = mines;
+    shownMinesLeft = mines;
+    closedSafe = Size() - mines;
+    generated = true;
+}
+
+/*
+===================
+Board::Reveal
+===================
+*/
+void Board::Reveal(int x, int y, int nearestMines)
+{
+    int index = Index(x, y);
+
+    tiles[index].nearestMines = static_cast<uint8_t>(nearestMines);
+    closedSafe--;
+    generated = true;
+
+    SetState(index, Tile::OPEN);
+}
+
+/*
+===================
+Board::SetStates
+===================
+*/
+void Board::SetStates(const std::vector<Tile::state_t> &states)
+{
+    minesLeft = mines;
+    shownMinesLeft = mines;
+    closedSafe = Size() - mines;
+    exploded = -1;
+    state = PLAYING;
+    generation++;
+    changes.clear();
+
+    for (int i = 0; i < Size(); i++)
+    {
+        Tile &tile = tiles[i];
+        tile.state = states[i];
+
+        if (tile.state == Tile::CLOSED)
+            continue;
+
+        changes.push_back(i);
+
+        if (tile.state == Tile::FLAGGED)
+        {
+            shownMinesLeft--;
+
+            if (tile.type == Tile::MINED)
+                minesLeft--;
+        }
+        else if (tile.state == Tile::OPEN)
+        {
+            if (tile.type != Tile::MINED)
+                closedSafe--;
+            else if (exploded < 0)
+                exploded = i;
+        }
+    }
+
+    if (exploded >= 0)
+        state = LOST;
+    else if (!closedSafe)
+        state = WON;
+}
+
+/*
+===================
+Board::RestoreTile
+===================
+*/
+void Board::RestoreTile(int index, Tile::state_t state)
+{
+    if (tiles[index].state == Tile::OPEN && state != Tile::OPEN)
+        reverts++;
+
+    SetState(index, state);
+}
+
+/*
+===================
+Board::RestoreCounters
+===================
+*/
+void Board::RestoreCounters(const counters_t &counters)
+{
+    minesLeft = counters.minesLeft;
+    shownMinesLeft = counters.shownMinesLeft;
+    closedSafe = counters.closedSafe;
+    exploded = counters.exploded;
+    state = counters.state;
+}
+
+/*
+===================
+Board::Open
+
+Mines have to be generated before the first tile is opened.
+===================
+*/
+void Board::Open(int x, int y)
+{
+    if (state != PLAYING || !IsInside(x, y))
+        return;
+
+    OpenTile(Index(x, y));
+}
+
+/*
+===================
+Board::Chord
+
+This allows to quickly reveal adjacent tiles if the number of mines matches the number of flags.
+===================
+*/
+void Board::Chord(int x, int y)
+{
+    if (state != PLAYING || !IsInside(x, y))
+        return;
+
+    const Tile &tile = tiles[Index(x, y)];
+
+    // A chord is allowed only if we have at least one mine
+    if (tile.state != Tile::OPEN || !tile.nearestMines)
+        return;
+
+    int flags = 0;
+
+    for (int j = y - 1; j <= y + 1; j++)
+        for (int i = x - 1; i <= x + 1; i++)
+            if (IsInside(i, j) && tiles[Index(i, j)].state == Tile::FLAGGED)
+                flags++;
+
+    if (flags != tile.nearestMines)
+        return;
+
+    // Every adjacent tile is opened even if one of them turns out to be a mine
+    for (int j = y - 1; j <= y + 1; j++)
+        for (int i = x - 1; i <= x + 1; i++)
+            if (IsInside(i, j))
+                OpenTile(Index(i, j));
+}
+
+/*
+===================
+Board::ToggleFlag
+
+Sets/unsets flags and question marks
+===================
+*/
+void Board::ToggleFlag(int x, int y, bool marksEnabled)
+{
+    if (state != PLAYING || !IsInside(x, y))
+        return;
+
+    int index = Index(x, y);
+    const Tile &tile = tiles[index];
+
+    // Flagged
+    if (tile.state == Tile::CLOSED)
+    {
+        shownMinesLeft--;
+
+        if (tile.type == Tile::MINED)
+            minesLeft--;
+
+        SetState(index, Tile::FLAGGED);
+    }
+    // Question mark
+    else if (tile.state == Tile::FLAGGED)
+    {
+        shownMinesLeft++;
+
+        if (tile.type == Tile::MINED)
+            minesLeft++;
+
+        SetState(index, marksEnabled ? Tile::QUESTIONED : Tile::CLOSED);
+    }
+    // Closed empty tile
+    else if (tile.state == Tile::QUESTIONED)
+    {
+        SetState(index, Tile::CLOSED);
+    }
+}
+
+/*
+===================
+Board::OpenTile
+===================
+*/
+void Board::OpenTile(int index)
+{
+    Tile &tile = tiles[index];
+
+    if (!tile.CanOpen())
+        return;
+
+    SetState(index, Tile::OPEN);
+
+    // Game over - mine explosion
+    if (tile.type == Tile::MINED)
+    {
+        if (state == PLAYING)
+        {
+            state = LOST;
+            exploded = index;
+        }
+
+        return;
+    }
+
+    closedSafe--;
+
+    if (tile.HasNoNearestMines())
+        OpenEmptyNeighborTiles(index);
+
+    if (!closedSafe && state == PLAYING)
+    {
+        state = WON;
+        FlagClosedMineTiles();
+    }
+}
+
+/*
+===================
+Board::OpenEmptyNeighborTiles
+
+Flood fill from a tile without nearest mines, flags in the way are opened as well.
+===================
+*/
+void Board::OpenEmptyNeighborTiles(int index)
+{
+    openStack.clear();
+    openStack.push_back(index);
+
+    while (!openStack.empty())
+    {
+        int current = openStack.back();
+        openStack.pop_back();
+
+        int x = X(current), y = Y(current);
+
+        for (int j = y - 1; j <= y + 1; j++)
+        {
+            for (int i = x - 1; i <= x + 1; i++)
+            {
+                if (!IsInside(i, j))
+                    continue;
+
+                int neighbor = Index(i, j);
+                Tile &tile = tiles[neighbor];
+
+                if (tile.type == Tile::MINED || tile.state == Tile::OPEN)
+                    continue;
+
+                if (tile.state == Tile::FLAGGED)
+                    shownMinesLeft++;
+
+                SetState(neighbor, Tile::OPEN);
+                closedSafe--;
+
+                if (!tile.nearestMines)
+                    openStack.push_back(neighbor);
+            }
+        }
+    }
+}
+
+/*
+===================
+Board::FlagClosedMineTiles
+===================
+*/
+void Board::FlagClosedMineTiles()
+{
+    for (int i = 0; i < Size(); i++)
+    {
+        const Tile &tile = tiles[i];
+
+        if (tile.type != Tile::MINED || tile.state == Tile::OPEN || tile.state == Tile::FLAGGED)
+            continue;
+
+        SetState(i, Tile::FLAGGED);
+        shownMinesLeft--;
+    }
+}
+
+/*
+===================
+Board::SetState
+===================
+*/
+void Board::SetState(int index, Tile::state_t newState)
+{
+    tiles[index].state = newState;
+    changes.push_back(index);
+}
@@ -0,0 +1,189 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Tile.h"
+
+#include <vector>
+
+// Field sizes the game allows
+#define MINIMAL_FIELD_WIDTH         10
+#define MINIMAL_FIELD_HEIGHT        10
+#define MAXIMAL_FIELD_WIDTH         70
+#define MAXIMAL_FIELD_HEIGHT        35
+
+/*
+===========================================================
+
+    Board
+
+    The rules of the game without rendering or input. The game, the
+    solvers and the offline tools all play on this.
+
+    Tiles are stored row by row. Every state change is appended to a
+    journal, so listeners can catch up on just the tiles that changed.
+
+===========================================================
+*/
+class Board
+{
+public:
+
+    enum state_t
+    {
+        PLAYING,
+        WON,
+        LOST
+    };
+
+    struct counters_t
+    {
+        int             minesLeft = 0;
+        int             shownMinesLeft = 0;
+        int             closedSafe = 0;
+        int             exploded = -1;
+        state_t         state = PLAYING;
+    };
+
+    void                Reset(int width, int height, int mines);
+
+    template<typename random_t>
+    void                GenerateMines(int x, int y, random_t &&random);
+
+    // Mines that were chosen elsewhere, like a generator that tests its boards first
+    void                PlaceMines(const std::vector<int> &mined);
+
+    // An open number from a position recorded elsewhere, where the mines are unknown. Such a board can be analyzed but not played
+    void                Reveal(int x, int y, int nearestMines);
+
+    // Puts the tiles of a generated board back into a position of the same game, like a keyframe of a replay.
+    // The journal starts over with every tile that isn't closed.
+    void                SetStates(const std::vector<Tile::state_t> &states);
+
+    // Puts single tiles back into a position of the same game, like an undone move, and then the counters of that position.
+    // Unlike SetStates, only the tiles that are put back go into the journal.
+    void                RestoreTile(int index, Tile::state_t state);
+    void                RestoreCounters(const counters_t &counters);
+    counters_t          Counters() const { return { minesLeft, shownMinesLeft, closedSafe, exploded, state }; }
+
+    // Tiles that never get a mine when the first click is at x, y
+    bool                IsInSafeZone(int index, int x, int y) const;
+
+    void                Open(int x, int y);
+    void                Chord(int x, int y);
+    void                ToggleFlag(int x, int y, bool marksEnabled);
+
+    int                 Width() const { return width; }
+    int                 Height() const { return height; }
+    int                 Size() const { return width * height; }
+    int                 Mines() const { return mines; }
+    int                 MinesLeft() const { return minesLeft; }
+    int                 ShownMinesLeft() const { return shownMinesLeft; }
+    int                 ClosedSafeTiles() const { return closedSafe; }
+    state_t             State() const { return state; }
+    bool                IsGenerated() const { return generated; }
+    int                 Exploded() const { return exploded; }
+
+    bool                IsInside(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+    int                 Index(int x, int y) const { return y * width + x; }
+    int                 X(int index) const { return index % width; }
+    int                 Y(int index) const { return index / width; }
+    const Tile &        At(int x, int y) const { return tiles[Index(x, y)]; }
+    const Tile &        operator[](int index) const { return tiles[index]; }
+
+    // Tiles whose state changed since the last reset, in order
+    const std::vector<int> &Changes() const { return changes; }
+    unsigned            Generation() const { return generation; }
+
+    // Counts the open tiles that were closed again, what was learned from them no longer holds
+    unsigned            Reverts() const { return reverts; }
+
+private:
+
+    void                OpenTile(int index);
+    void                OpenEmptyNeighborTiles(int index);
+    void                FlagClosedMineTiles();
+    void                SetState(int index, Tile::state_t newState);
+
+    std::vector<Tile>   tiles;
+    std::vector<int>    candidates;
+    std::vector<int>    openStack;
+    std::vector<int>    changes;
+
+    int                 width = 0;
+    int                 height = 0;
+    int                 mines = 0;
+    int                 minesLeft = 0;
+    int                 shownMinesLeft = 0;
+    int                 closedSafe = 0;
+    int                 exploded = -1;
+    state_t             state = PLAYING;
+    bool                generated = false;
+    unsigned            generation = 0;
+    unsigned            reverts = 0;
+};
+
+/*
+===================
+Board::GenerateMines
+
+Places mines anywhere but around the first clicked tile.
+The random callable returns an integer in the inclusive [min, max] range.
+===================
+*/
+template<typename random_t>
+void Board::GenerateMines(int x, int y, random_t &&random)
+{
+    candidates.clear();
+
+    for (int i = 0; i < Size(); i++)
+        if (!IsInSafeZone(i, x, y))
+            candidates.push_back(i);
+
+    std::vector<int> mined;
+    mined.reserve(mines);
+
+    for (int i = 0; i < mines && !candidates.empty(); i++)
+    {
+        int n = random(0, static_cast<int>(candidates.size()) - 1);
+        mined.push_back(candidates[n]);
+        candidates[n] = candidates.back();
+        candidates.pop_back();
+    }
+
+    PlaceMines(mined);
+}
+
+/*
+===================
+Board::IsInSafeZone
+===================
+*/
+inline bool Board::IsInSafeZone(int index, int x, int y) const
+{
+    int dx = X(index) - x;
+    int dy = Y(index) - y;
+
+    // There should be no mines in adjacent tiles if the number of mines is 9 fewer than the total number of tiles
+    if (Size() - mines >= 9)
+        return dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1;
+
+    return !dx && !dy;
+}
@@ -0,0 +1,156 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "BoardCode.h"
+
+#define WIDTH_BITS                  6
+#define HEIGHT_BITS                 5
+#define MINES_BITS                  12
+#define CLICK_BITS                  12
+#define CHECK_BITS                  5
+
+static const char symbols[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+static_assert(MAXIMAL_FIELD_WIDTH - MINIMAL_FIELD_WIDTH < (1 << WIDTH_BITS), "Widths don't fit into a code");
+static_assert(MAXIMAL_FIELD_HEIGHT - MINIMAL_FIELD_HEIGHT < (1 << HEIGHT_BITS), "Heights don't fit into a code");
+static_assert(MAXIMAL_FIELD_WIDTH * MAXIMAL_FIELD_HEIGHT <= (1 << MINES_BITS), "Tiles don't fit into a code");
+static_assert(WIDTH_BITS + HEIGHT_BITS + MINES_BITS + CLICK_BITS + BOARD_CODE_SEED_BITS + CHECK_BITS == BOARD_CODE_SYMBOLS * 5, "Codes have to fill their symbols");
+
+/*
+===================
+Check
+===================
+*/
+static uint32_t Check(uint64_t high, uint64_t low)
+{
+    uint64_t hash = (high * 0x9E3779B97F4A7C15ull) ^ low;
+    hash = (hash ^ (hash >> 31)) * 0xBF58476D1CE4E5B9ull;
+
+    return static_cast<uint32_t>(hash >> 59);
+}
+
+/*
+===================
+BoardCode::Encode
+===================
+*/
+std::string BoardCode::Encode(const code_t &code)
+{
+    if (code.width < MINIMAL_FIELD_WIDTH || code.width > MAXIMAL_FIELD_WIDTH || code.height < MINIMAL_FIELD_HEIGHT ||
+        code.height > MAXIMAL_FIELD_HEIGHT || code.mines <= 0 || code.mines >= code.width * code.height ||
+        code.x < 0 || code.y < 0 || code.x >= code.width || code.y >= code.height || code.seed > BOARD_CODE_SEED_MASK)
+        return std::string();
+
+    // 35 bits of the field and the click, then the seed
+    uint64_t high = static_cast<uint64_t>(code.width - MINIMAL_FIELD_WIDTH);
+    high = (high << HEIGHT_BITS) | static_cast<uint64_t>(code.height - MINIMAL_FIELD_HEIGHT);
+    high = (high << MINES_BITS) | static_cast<uint64_t>(code.mines);
+    high = (high << CLICK_BITS) | static_cast<uint64_t>(code.y * code.width + code.x);
+
+    uint64_t low = code.seed;
+    uint32_t check = Check(high, low);
+    std::string text;
+
+    for (int symbol = 0; symbol < BOARD_CODE_SYMBOLS; symbol++)
+    {
+        // The 80 bits are high, low and the checksum, read 5 at a time from the top
+        int bit = (BOARD_CODE_SYMBOLS - 1 - symbol) * 5;
+        uint32_t value;
+
+        if (bit >= CHECK_BITS + BOARD_CODE_SEED_BITS)
+            value = static_cast<uint32_t>(high >> (bit - CHECK_BITS - BOARD_CODE_SEED_BITS));
+        else if (bit >= CHECK_BITS)
+            value = static_cast<uint32_t>(low >> (bit - CHECK_BITS));
+        else
+            value = check;
+
+        if (symbol && !(symbol % 4))
+            text += '-';
+
+        text += symbols[value & 31];
+    }
+
+    return text;
+}
+
+/*
+===================
+BoardCode::Decode
+===================
+*/
+bool BoardCode::Decode(const char *text, code_t &code)
+{
+    uint64_t high = 0, low = 0;
+    uint32_t check = 0;
+    int count = 0;
+
+    for (const char *c = text; *c; c++)
+    {
+        if (*c == '-' || *c == ' ')
+            continue;
+
+        int value = Value(*c);
+
+        if (value < 0 || count == BOARD_CODE_SYMBOLS)
+            return false;
+
+        // Shifts the 80 bits left by 5 and adds the symbol at the bottom
+        high = (high << 5) | (low >> (BOARD_CODE_SEED_BITS - 5));
+        low = ((low << 5) | check) & BOARD_CODE_SEED_MASK;
+        check = static_cast<uint32_t>(value);
+        count++;
+    }
+
+    if (count != BOARD_CODE_SYMBOLS || Check(high, low) != check)
+        return false;
+
+    int click = static_cast<int>(high & ((1 << CLICK_BITS) - 1));
+    code.mines = static_cast<int>((high >> CLICK_BITS) & ((1 << MINES_BITS) - 1));
+    code.height = static_cast<int>((high >> (CLICK_BITS + MINES_BITS)) & ((1 << HEIGHT_BITS) - 1)) + MINIMAL_FIELD_HEIGHT;
+    code.width = static_cast<int>(high >> (CLICK_BITS + MINES_BITS + HEIGHT_BITS)) + MINIMAL_FIELD_WIDTH;
+    code.x = click % code.width;
+    code.y = click / code.width;
+    code.seed = low;
+
+    return code.width <= MAXIMAL_FIELD_WIDTH && code.height <= MAXIMAL_FIELD_HEIGHT && code.mines > 0 &&
+           code.mines < code.width * code.height && click < code.width * code.height;
+}
+
+/*
+===================
+BoardCode::Value
+===================
+*/
+int BoardCode::Value(char c)
+{
+    if (c >= 'a' && c <= 'z')
+        c = static_cast<char>(c - 'a' + 'A');
+
+    if (c == 'O')
+        return 0;
+
+    if (c == 'I' || c == 'L')
+        return 1;
+
+    for (int i = 0; i < 32; i++)
+        if (symbols[i] == c)
+            return i;
+
+    return -1;
+}
@@ -0,0 +1,70 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Board.h"
+
+#include <cstdint>
+#include <string>
+
+#define BOARD_CODE_SYMBOLS          16      // Not counting the dashes between groups of four
+#define BOARD_CODE_SEED_BITS        40
+#define BOARD_CODE_SEED_MASK        ((1ull << BOARD_CODE_SEED_BITS) - 1)
+
+/*
+===========================================================
+
+    BoardCode
+
+    A short code that makes the same board again, to share it or play
+    it once more. A seed and the first click decide where the mines go,
+    so the code holds both along with the field size and mine count.
+
+    80 bits as 16 symbols of Crockford's base 32, which has no letters
+    that look alike. Decoding ignores case and dashes, reads O as 0 and
+    I or L as 1, and a 5 bit checksum catches almost every typo.
+
+===========================================================
+*/
+class BoardCode
+{
+public:
+
+    struct code_t
+    {
+        int             width = 0;
+        int             height = 0;
+        int             mines = 0;
+        int             x = 0;              // First click
+        int             y = 0;
+        uint64_t        seed = 0;
+    };
+
+    // Returns an empty string if the board doesn't fit into a code
+    static std::string  Encode(const code_t &code);
+    static bool         Decode(const char *text, code_t &code);
+
+    // A symbol that may appear in a code, including the ones read as others
+    static bool         IsSymbol(char c) { return Value(c) >= 0; }
+
+private:
+
+    static int          Value(char c);
+};
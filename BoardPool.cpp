@@ -0,0 +1,270 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "BoardPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+/*
+===================
+BoardPool::Start
+===================
+*/
+void BoardPool::Start(const Board &board)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (board.Width() != shape.Width() || board.Height() != shape.Height() || board.Mines() != shape.Mines())
+        {
+            shape.Reset(board.Width(), board.Height(), board.Mines());
+            failures = 0;
+            entries.clear();
+            version++;
+        }
+
+        hintX = hintY = -1;
+    }
+
+    if (!worker.joinable())
+    {
+        stop = false;
+        generator.seed = seed + 1;
+        takeRandom = Random(seed, 1);
+        worker = std::thread(&BoardPool::Work, this);
+    }
+
+    wake.notify_one();
+}
+
+/*
+===================
+BoardPool::Stop
+===================
+*/
+void BoardPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+
+    wake.notify_one();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+/*
+===================
+BoardPool::Hint
+===================
+*/
+void BoardPool::Hint(int x, int y)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (x == hintX && y == hintY)
+            return;
+
+        hintX = x;
+        hintY = y;
+    }
+
+    wake.notify_one();
+}
+
+/*
+===================
+BoardPool::Take
+===================
+*/
+bool BoardPool::Take(Board &board, int x, int y)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (board.IsGenerated() || board.Width() != shape.Width() || board.Height() != shape.Height() ||
+        board.Mines() != shape.Mines())
+        return false;
+
+    int found = -1;
+    std::vector<int> mined;
+
+    // A board made for this very tile
+    for (size_t i = 0; i < entries.size() && found < 0; i++)
+    {
+        if (entries[i].x == x && entries[i].y == y)
+        {
+            found = static_cast<int>(i);
+            mined = entries[i].mined;
+        }
+    }
+
+    for (size_t i = 0; i < entries.size() && found < 0; i++)
+    {
+        mined = entries[i].mined;
+        Relocate(board, mined, x, y, takeRandom);
+
+        // Moving mines around changes the numbers, so it might need a guess now
+        Board test = board;
+        test.PlaceMines(mined);
+
+        if (!Generator::IsSolvable(test, solver, x, y))
+            continue;
+
+        found = static_cast<int>(i);
+    }
+
+    if (found < 0)
+        return false;
+
+    entries.erase(entries.begin() + found);
+    lock.unlock();
+    wake.notify_one();
+
+    board.PlaceMines(mined);
+    return true;
+}
+
+/*
+===================
+BoardPool::IsFailing
+===================
+*/
+bool BoardPool::IsFailing()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return failures >= BOARD_POOL_MAX_FAILURES;
+}
+
+/*
+===================
+BoardPool::Work
+===================
+*/
+void BoardPool::Work()
+{
+    Random random(seed, 0);
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (!stop)
+    {
+        bool hinted = shape.IsInside(hintX, hintY) && !HasEntryFor(hintX, hintY);
+
+        if (!hinted && entries.size() >= BOARD_POOL_SIZE)
+        {
+            wake.wait(lock);
+            continue;
+        }
+
+        Board board = shape;
+        unsigned makeVersion = version;
+        entry_t entry;
+        entry.x = hinted ? hintX : random.Int(0, board.Width() - 1);
+        entry.y = hinted ? hintY : random.Int(0, board.Height() - 1);
+
+        lock.unlock();
+
+        bool made = generator.Generate(board, entry.x, entry.y);
+
+        for (int i = 0; i < board.Size() && made; i++)
+            if (board[i].type == Tile::MINED)
+                entry.mined.push_back(i);
+
+        lock.lock();
+
+        // Restarted with another shape in the meantime
+        if (makeVersion != version)
+            continue;
+
+        if (!made)
+        {
+            // Hints don't cut the delay short, only a new shape or stopping does
+            int delay = std::min(BOARD_POOL_RETRY_DELAY << std::min(failures, 16), BOARD_POOL_MAX_RETRY_DELAY);
+            failures++;
+            wake.wait_for(lock, std::chrono::milliseconds(delay), [&]() { return stop || makeVersion != version; });
+            continue;
+        }
+
+        failures = 0;
+
+        // The hovered tile is more important than the oldest board
+        if (entries.size() >= BOARD_POOL_SIZE)
+            entries.erase(entries.begin());
+
+        entries.push_back(std::move(entry));
+    }
+}
+
+/*
+===================
+BoardPool::HasEntryFor
+===================
+*/
+bool BoardPool::HasEntryFor(int x, int y) const
+{
+    for (const entry_t &entry : entries)
+        if (entry.x == x && entry.y == y)
+            return true;
+
+    return false;
+}
+
+/*
+===================
+BoardPool::Relocate
+
+Moves mines out of the safe zone to random free tiles outside of it, so a board made for another tile can be checked for this one.
+===================
+*/
+void BoardPool::Relocate(const Board &board, std::vector<int> &mined, int x, int y, Random &random) const
+{
+    std::vector<uint8_t> occupied(board.Size(), 0);
+    int moved = 0;
+
+    for (int index : mined)
+        occupied[index] = 1;
+
+    mined.erase(std::remove_if(mined.begin(), mined.end(), [&](int index)
+    {
+        if (!board.IsInSafeZone(index, x, y))
+            return false;
+
+        moved++;
+        return true;
+    }), mined.end());
+
+    if (!moved)
+        return;
+
+    std::vector<int> free;
+
+    for (int i = 0; i < board.Size(); i++)
+        if (!occupied[i] && !board.IsInSafeZone(i, x, y))
+            free.push_back(i);
+
+    for (int i = 0; i < moved && i < static_cast<int>(free.size()); i++)
+    {
+        int n = random.Int(i, static_cast<int>(free.size()) - 1);
+        std::swap(free[i], free[n]);
+        mined.push_back(free[i]);
+    }
+}
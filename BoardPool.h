@@ -0,0 +1,102 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Generator.h"
+#include "Random.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define BOARD_POOL_SIZE             8       // Boards kept ready for the first click
+#define BOARD_POOL_RETRY_DELAY      100     // Milliseconds before searching again after a failed search, doubles with every failure
+#define BOARD_POOL_MAX_RETRY_DELAY  5000
+#define BOARD_POOL_MAX_FAILURES     3       // Failed searches in a row after which the pool is considered failing
+
+/*
+===========================================================
+
+    BoardPool
+
+    Searches for no-guess boards on a worker thread while the player
+    looks at the fresh field, so the first click doesn't wait for them.
+
+    A no-guess board only works from the tile it was made for, so the
+    worker prepares one for the hovered tile first. A board made for
+    another tile has the mines in the safe zone moved to random free
+    tiles and is checked again.
+
+    A failed search is tried again after a delay that doubles with
+    every failure in a row, a new shape or a found board resets it.
+
+===========================================================
+*/
+class BoardPool
+{
+public:
+
+                        ~BoardPool() { Stop(); }
+
+    // Starts filling the pool with boards like this one, keeps what it has if nothing changed
+    void                Start(const Board &board);
+    void                Stop();
+
+    // The tile the first click is likely to land on
+    void                Hint(int x, int y);
+
+    // Places mines from the pool into a reset board, returns false if nothing fits
+    bool                Take(Board &board, int x, int y);
+
+    // Whether the last BOARD_POOL_MAX_FAILURES searches for this shape all failed
+    bool                IsFailing();
+
+    uint64_t            seed = 0;
+
+private:
+
+    struct entry_t
+    {
+        int             x = 0;              // Tile the board was made for
+        int             y = 0;
+        std::vector<int> mined;
+    };
+
+    void                Work();
+    bool                HasEntryFor(int x, int y) const;
+    void                Relocate(const Board &board, std::vector<int> &mined, int x, int y, Random &random) const;
+
+    Board               shape;              // Reset board the pool is filled for
+    int                 failures = 0;       // Failed searches in a row
+    int                 hintX = -1;
+    int                 hintY = -1;
+    unsigned            version = 0;
+    std::vector<entry_t> entries;
+
+    Generator           generator;
+    Random              takeRandom;
+    Solver              solver;
+
+    std::mutex          mutex;
+    std::condition_variable wake;
+    std::thread         worker;
+    bool                stop = false;
+};
@@ -0,0 +1,63 @@
+// Generated by MinefieldSpriteSheet from Boom*.tga, don't edit it by hand
+// ../Resources/Boom Boom Data/Textures/BoomSheet.tga ../BoomSheet.h BOOM 2
+
+#pragma once
+
+#define BOOM_SHEET_WIDTH            704
+#define BOOM_SHEET_HEIGHT           232
+#define BOOM_FRAME_WIDTH            64
+#define BOOM_FRAME_HEIGHT           64
+#define BOOM_FRAMES                 48
+
+// Sheet x, y, width, height, then the offset of the trimmed rectangle inside the original frame
+static const int boomSheetFrames[BOOM_FRAMES][6] =
+{
+    { 621, 180, 38, 38, 13, 14 },
+    { 416, 180, 39, 40, 13, 13 },
+    { 456, 180, 40, 40, 12, 13 },
+    { 497, 180, 40, 40, 12, 13 },
+    { 538, 180, 40, 40, 12, 13 },
+    { 331, 180, 40, 43, 12, 10 },
+    { 289, 180, 41, 44, 12, 9 },
+    { 244, 180, 44, 45, 10, 8 },
+    { 196, 180, 47, 47, 8, 7 },
+    { 49, 180, 48, 50, 7, 6 },
+    { 516, 122, 51, 52, 5, 5 },
+    { 568, 122, 53, 52, 4, 5 },
+    { 461, 122, 54, 53, 3, 5 },
+    { 351, 122, 55, 54, 3, 5 },
+    { 294, 122, 56, 55, 2, 4 },
+    { 176, 122, 58, 56, 1, 4 },
+    { 235, 122, 58, 56, 1, 4 },
+    { 0, 122, 59, 57, 0, 4 },
+    { 60, 122, 59, 57, 0, 4 },
+    { 632, 62, 64, 58, 0, 3 },
+    { 452, 0, 64, 59, 0, 3 },
+    { 517, 0, 64, 59, 0, 3 },
+    { 582, 0, 64, 59, 0, 3 },
+    { 0, 62, 59, 59, 0, 3 },
+    { 60, 62, 64, 59, 0, 3 },
+    { 125, 62, 64, 59, 0, 3 },
+    { 190, 62, 64, 59, 0, 3 },
+    { 255, 62, 64, 59, 0, 4 },
+    { 320, 62, 64, 59, 0, 4 },
+    { 385, 62, 64, 59, 0, 4 },
+    { 195, 0, 64, 60, 0, 3 },
+    { 260, 0, 61, 60, 0, 3 },
+    { 322, 0, 64, 60, 0, 3 },
+    { 387, 0, 64, 60, 0, 3 },
+    { 0, 0, 64, 61, 0, 2 },
+    { 65, 0, 64, 61, 0, 2 },
+    { 130, 0, 64, 61, 0, 2 },
+    { 450, 62, 61, 59, 0, 2 },
+    { 512, 62, 61, 59, 0, 2 },
+    { 574, 62, 57, 59, 4, 2 },
+    { 120, 122, 55, 57, 4, 2 },
+    { 407, 122, 53, 54, 5, 3 },
+    { 622, 122, 53, 52, 5, 5 },
+    { 0, 180, 48, 51, 10, 5 },
+    { 98, 180, 48, 48, 10, 7 },
+    { 147, 180, 48, 48, 10, 7 },
+    { 372, 180, 43, 43, 9, 11 },
+    { 579, 180, 41, 40, 9, 12 },
+};
@@ -0,0 +1,144 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Bot.h"
+
+#include <chrono>
+
+/*
+===================
+SolverBot::SolverBot
+===================
+*/
+SolverBot::SolverBot(guessing_t guessing, uint64_t seed) : guessing(guessing), random(seed)
+{
+    // Bots usually play many games side by side, one thread each is enough
+    endgame.threads = 1;
+}
+
+/*
+===================
+SolverBot::Reset
+===================
+*/
+void SolverBot::Reset(const Board &board)
+{
+    solver.Reset(board);
+}
+
+/*
+===================
+SolverBot::NextMove
+===================
+*/
+bool SolverBot::NextMove(const Board &board, move_t &move)
+{
+    if (board.State() != Board::PLAYING)
+        return false;
+
+    // The middle is the most likely tile to open an area
+    if (!board.IsGenerated())
+    {
+        move = { OPEN, board.Width() / 2, board.Height() / 2 };
+        return true;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    solver.Update(board);
+
+    int tile = -1;
+    action_t action = OPEN;
+
+    if (flagMines)
+    {
+        for (int index : solver.MineTiles())
+        {
+            if (board[index].state == Tile::CLOSED)
+            {
+                tile = index;
+                action = FLAG;
+                break;
+            }
+        }
+    }
+
+    if (tile < 0 && !solver.SafeTiles().empty())
+        tile = solver.SafeTiles()[0];
+
+    auto deduced = std::chrono::steady_clock::now();
+    stats.deduceMilliseconds += std::chrono::duration<double, std::milli>(deduced - started).count();
+
+    if (tile >= 0)
+    {
+        stats.deductions++;
+    }
+    else
+    {
+        tile = Guess(board);
+        stats.guesses++;
+        stats.guessMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - deduced).count();
+    }
+
+    if (tile < 0)
+        return false;
+
+    move = { action, board.X(tile), board.Y(tile) };
+    return true;
+}
+
+/*
+===================
+SolverBot::Guess
+===================
+*/
+int SolverBot::Guess(const Board &board)
+{
+    if (guessing == ENDGAME)
+    {
+        Endgame::result_t result;
+
+        if (endgame.Search(board, solver, result))
+            return result.tile;
+    }
+
+    probability.maxNodes = maxNodes;
+
+    bool useProbability = guessing != RANDOM && probability.Compute(board, solver);
+    int best = -1;
+    int candidates = 0;
+
+    for (int i = 0; i < board.Size(); i++)
+    {
+        if (board[i].state != Tile::CLOSED || solver.Knowledge(i) != Solver::UNKNOWN)
+            continue;
+
+        if (useProbability)
+        {
+            if (best < 0 || probability.At(i) < probability.At(best))
+                best = i;
+        }
+        // Uniformly among all unknown tiles, without storing them
+        else if (!random.Int(0, candidates++))
+        {
+            best = i;
+        }
+    }
+
+    return best;
+}
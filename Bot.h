@@ -0,0 +1,115 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Probability.h"
+#include "Endgame.h"
+#include "Random.h"
+
+#include <cstdint>
+
+/*
+===========================================================
+
+    Bot
+
+    A player that only sees what a human sees on the board. The caller
+    applies its moves with the same rules the game uses.
+
+===========================================================
+*/
+class Bot
+{
+public:
+
+    enum action_t
+    {
+        OPEN,
+        CHORD,
+        FLAG
+    };
+
+    struct move_t
+    {
+        action_t        action = OPEN;
+        int             x = 0;
+        int             y = 0;
+    };
+
+    virtual             ~Bot() = default;
+
+    // Called after the board is reset, before the first move
+    virtual void        Reset(const Board &) {}
+
+    // Returns false to give up
+    virtual bool        NextMove(const Board &board, move_t &move) = 0;
+};
+
+/*
+===========================================================
+
+    SolverBot
+
+    Opens whatever the solver proves safe and guesses only when it's
+    stuck, either at random, on the tile least likely to be a mine, or
+    with an endgame search once few tiles are left.
+
+===========================================================
+*/
+class SolverBot : public Bot
+{
+public:
+
+    enum guessing_t
+    {
+        RANDOM,
+        PROBABILITY,
+        ENDGAME
+    };
+
+    struct stats_t
+    {
+        uint64_t        deductions = 0;
+        uint64_t        guesses = 0;
+        double          deduceMilliseconds = 0.0;
+        double          guessMilliseconds = 0.0;
+    };
+
+                        SolverBot(guessing_t guessing, uint64_t seed = 0);
+
+    void                Reset(const Board &board) override;
+    bool                NextMove(const Board &board, move_t &move) override;
+
+    const stats_t &     Stats() const { return stats; }
+
+    bool                flagMines = false;  // Flags proven mines like a player would, costs moves
+    int                 maxNodes = PROBABILITY_MAX_NODES;   // Lower guesses faster, but at random more often
+
+private:
+
+    int                 Guess(const Board &board);
+
+    guessing_t          guessing;
+    Random              random;
+    Solver              solver;
+    Probability         probability;
+    Endgame             endgame;
+    stats_t             stats;
+};
@@ -0,0 +1,134 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "BotHost.h"
+
+#include <cstring>
+
+/*
+===================
+BotHost::Open
+===================
+*/
+bool BotHost::Open(const char *name)
+{
+    Close();
+
+    if (!memory.Create(name, sizeof(mf_shared_t)))
+        return false;
+
+    shared = static_cast<mf_shared_t *>(memory.Data());
+    std::memset(shared, 0, sizeof(mf_shared_t));
+
+    shared->version = MF_VERSION;
+    shared->ringSize = MF_RING_SIZE;
+    published = false;
+
+    // Bots check the magic first, so it goes last
+    std::atomic_ref<uint32_t>(shared->magic).store(MF_MAGIC, std::memory_order_release);
+
+    return true;
+}
+
+/*
+===================
+BotHost::Publish
+===================
+*/
+void BotHost::Publish(const Board &board)
+{
+    if (!shared || board.Width() > MF_MAX_WIDTH || board.Height() > MF_MAX_HEIGHT)
+        return;
+
+    const std::vector<int> &journal = board.Changes();
+    bool fresh = !published || generation != board.Generation();
+
+    if (!fresh && changes == journal.size() && minesLeft == board.ShownMinesLeft() && state == board.State())
+        return;
+
+    // Odd while writing, readers that overlap with it try again
+    std::atomic_ref<uint32_t> sequence(shared->sequence);
+    uint32_t value = sequence.load(std::memory_order_relaxed);
+    sequence.store(value + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (fresh)
+    {
+        shared->width = board.Width();
+        shared->height = board.Height();
+        shared->mines = board.Mines();
+        shared->generation = board.Generation();
+
+        for (int i = 0; i < board.Size(); i++)
+            SetTile(i, VisibleTile(board, i));
+    }
+    else
+    {
+        for (size_t i = changes; i < journal.size(); i++)
+            SetTile(journal[i], VisibleTile(board, journal[i]));
+    }
+
+    shared->minesLeft = board.ShownMinesLeft();
+    shared->state = board.State() == Board::WON ? MF_WON : board.State() == Board::LOST ? MF_LOST : MF_PLAYING;
+
+    sequence.store(value + 2, std::memory_order_release);
+
+    published = true;
+    generation = board.Generation();
+    changes = journal.size();
+    minesLeft = board.ShownMinesLeft();
+    state = board.State();
+}
+
+/*
+===================
+BotHost::SetTile
+===================
+*/
+void BotHost::SetTile(int index, int value)
+{
+    uint8_t &pair = shared->tiles[index >> 1];
+    int shift = (index & 1) * 4;
+
+    pair = static_cast<uint8_t>((pair & ~(15 << shift)) | (value << shift));
+}
+
+/*
+===================
+BotHost::VisibleTile
+===================
+*/
+int BotHost::VisibleTile(const Board &board, int index) const
+{
+    const Tile &tile = board[index];
+
+    if (tile.state == Tile::FLAGGED)
+        return MF_TILE_FLAGGED;
+
+    if (tile.state == Tile::QUESTIONED)
+        return MF_TILE_QUESTIONED;
+
+    if (tile.state != Tile::OPEN)
+        return MF_TILE_CLOSED;
+
+    if (tile.type == Tile::MINED)
+        return MF_TILE_MINE;
+
+    return tile.nearestMines;
+}
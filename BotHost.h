@@ -0,0 +1,109 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "BotLink.h"
+#include "Board.h"
+#include "SharedMemory.h"
+
+#include <atomic>
+
+#define BOT_HOST_BATCH              MF_RING_SIZE    // Commands carried out before the board is published again
+
+/*
+===========================================================
+
+    BotHost
+
+    The game's side of BotLink. Poll() carries out the commands bots
+    have submitted and publishes the board afterwards. Publishing only
+    rewrites the tiles the board's journal lists since the last time,
+    and nothing at all if the board hasn't changed.
+
+===========================================================
+*/
+class BotHost
+{
+public:
+
+    bool                Open(const char *name = MF_DEFAULT_NAME);
+    void                Close() { memory.Close(); shared = nullptr; }
+    bool                IsOpen() const { return shared != nullptr; }
+    const char *        Error() const { return memory.Error(); }
+
+    // Calls the handler for every command that has arrived, returns how many there were
+    template<typename handler_t>
+    int                 Poll(const Board &board, handler_t &&handler, int maxCommands = BOT_HOST_BATCH);
+
+    void                Publish(const Board &board);
+
+private:
+
+    void                SetTile(int index, int value);
+    int                 VisibleTile(const Board &board, int index) const;
+
+    SharedMemory        memory;
+    mf_shared_t *       shared = nullptr;
+
+    // What has been published so far
+    bool                published = false;
+    unsigned            generation = 0;
+    size_t              changes = 0;
+    int                 minesLeft = 0;
+    Board::state_t      state = Board::PLAYING;
+};
+
+/*
+===================
+BotHost::Poll
+===================
+*/
+template<typename handler_t>
+int BotHost::Poll(const Board &board, handler_t &&handler, int maxCommands)
+{
+    if (!shared)
+        return 0;
+
+    uint32_t head = std::atomic_ref<uint32_t>(shared->head).load(std::memory_order_acquire);
+    uint32_t tail = shared->tail;
+    int count = static_cast<int>(head - tail);
+
+    // A bot that wrote past the ring can't be trusted with anything it sent
+    if (count > MF_RING_SIZE)
+    {
+        count = 0;
+        tail = head;
+    }
+
+    if (count > maxCommands)
+        count = maxCommands;
+
+    for (int i = 0; i < count; i++)
+    {
+        mf_command_t command = shared->commands[(tail + i) & (MF_RING_SIZE - 1)];
+        handler(command);
+    }
+
+    // Bots see the tail move only once the board shows what their commands did
+    Publish(board);
+    std::atomic_ref<uint32_t>(shared->tail).store(tail + count, std::memory_order_release);
+
+    return count;
+}
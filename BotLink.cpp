@@ -0,0 +1,171 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "BotLink.h"
+#include "SharedMemory.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static_assert(MF_MAX_WIDTH * MF_MAX_HEIGHT <= MF_TILE_BYTES * 2, "MF_TILE_BYTES is too small");
+static_assert((MF_RING_SIZE & (MF_RING_SIZE - 1)) == 0, "MF_RING_SIZE must be a power of two");
+static_assert(sizeof(mf_command_t) == 8, "mf_command_t must stay 8 bytes");
+
+struct mf_link_t
+{
+    SharedMemory    memory;
+    mf_shared_t *   shared = nullptr;
+    uint32_t        head = 0;               // Only this bot writes it, so it's kept here as well
+};
+
+/*
+===================
+mf_connect
+===================
+*/
+mf_link_t *mf_connect(const char *name)
+{
+    mf_link_t *link = new mf_link_t;
+
+    if (!link->memory.Open(name ? name : MF_DEFAULT_NAME, sizeof(mf_shared_t)))
+    {
+        delete link;
+        return nullptr;
+    }
+
+    link->shared = static_cast<mf_shared_t *>(link->memory.Data());
+
+    if (std::atomic_ref<uint32_t>(link->shared->magic).load(std::memory_order_acquire) != MF_MAGIC ||
+        link->shared->version != MF_VERSION || link->shared->ringSize != MF_RING_SIZE)
+    {
+        delete link;
+        return nullptr;
+    }
+
+    link->head = std::atomic_ref<uint32_t>(link->shared->head).load(std::memory_order_relaxed);
+
+    return link;
+}
+
+/*
+===================
+mf_disconnect
+===================
+*/
+void mf_disconnect(mf_link_t *link)
+{
+    delete link;
+}
+
+/*
+===================
+mf_view
+===================
+*/
+const mf_shared_t *mf_view(const mf_link_t *link)
+{
+    return link->shared;
+}
+
+/*
+===================
+mf_read_begin
+
+Waits out a publish that is under way, it only takes a moment.
+===================
+*/
+uint32_t mf_read_begin(const mf_link_t *link)
+{
+    std::atomic_ref<uint32_t> sequence(link->shared->sequence);
+
+    for (;;)
+    {
+        uint32_t value = sequence.load(std::memory_order_acquire);
+
+        if (!(value & 1))
+            return value;
+
+        std::this_thread::yield();
+    }
+}
+
+/*
+===================
+mf_read_end
+===================
+*/
+int mf_read_end(const mf_link_t *link, uint32_t sequence)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return std::atomic_ref<uint32_t>(link->shared->sequence).load(std::memory_order_relaxed) == sequence;
+}
+
+/*
+===================
+mf_submit
+===================
+*/
+uint32_t mf_submit(mf_link_t *link, const mf_command_t *commands, uint32_t count)
+{
+    uint32_t tail = std::atomic_ref<uint32_t>(link->shared->tail).load(std::memory_order_acquire);
+    uint32_t space = MF_RING_SIZE - (link->head - tail);
+
+    if (count > space)
+        count = space;
+
+    for (uint32_t i = 0; i < count; i++)
+        link->shared->commands[(link->head + i) & (MF_RING_SIZE - 1)] = commands[i];
+
+    // A single store makes the whole batch visible
+    link->head += count;
+    std::atomic_ref<uint32_t>(link->shared->head).store(link->head, std::memory_order_release);
+
+    return count;
+}
+
+/*
+===================
+mf_pending
+===================
+*/
+uint32_t mf_pending(const mf_link_t *link)
+{
+    return link->head - std::atomic_ref<uint32_t>(link->shared->tail).load(std::memory_order_acquire);
+}
+
+/*
+===================
+mf_wait
+===================
+*/
+int mf_wait(const mf_link_t *link, uint32_t timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    while (mf_pending(link))
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+            return 0;
+
+        std::this_thread::yield();
+    }
+
+    return 1;
+}
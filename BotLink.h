@@ -0,0 +1,163 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+// This file doesn't depend on libEngine, and it's plain C so bots in any language can use it
+
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(MF_BOTLINK_BUILD)
+#define MF_API                      __declspec(dllexport)
+#elif defined(_WIN32) && defined(MF_BOTLINK_DLL)
+#define MF_API                      __declspec(dllimport)
+#elif defined(__GNUC__)
+#define MF_API                      __attribute__((visibility("default")))
+#else
+#define MF_API
+#endif
+
+#define MF_MAGIC                    0x4B4C464Du // "MFLK"
+#define MF_VERSION                  1
+#define MF_DEFAULT_NAME             "MinefieldBotLink"
+#define MF_MAX_WIDTH                70      // Same as the largest field of the game
+#define MF_MAX_HEIGHT               35
+#define MF_TILE_BYTES               1280    // Two tiles per byte, rounded up to whole cache lines
+#define MF_RING_SIZE                65536   // Commands, a power of two
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What a bot sees of a tile, 4 bits each
+enum mf_tile_t
+{
+    MF_TILE_0 = 0,                          // 0 to 8 are open tiles with that many mines around
+    MF_TILE_CLOSED = 9,
+    MF_TILE_FLAGGED = 10,
+    MF_TILE_QUESTIONED = 11,
+    MF_TILE_MINE = 12                       // The mine that exploded
+};
+
+enum mf_state_t
+{
+    MF_PLAYING,
+    MF_WON,
+    MF_LOST
+};
+
+enum mf_action_t
+{
+    MF_OPEN,
+    MF_CHORD,
+    MF_FLAG,                                // Toggles between closed and flagged
+    MF_RESTART                              // A new board of the same size, x and y are ignored
+};
+
+typedef struct mf_command_t
+{
+    uint8_t         action;                 // mf_action_t
+    uint8_t         reserved;
+    uint16_t        x;
+    uint16_t        y;
+    uint16_t        reserved2;
+} mf_command_t;
+
+/*
+===========================================================
+
+    BotLink
+
+    The C interface for bots that play from another process. Everything
+    here is plain C with fixed-size types and keeps its layout from one
+    release to the next, new fields only go into the reserved space.
+
+    The game, or the headless MinefieldBotHost, keeps the visible board
+    in a shared memory segment. Bots read it in place: a read is
+    consistent if mf_read_begin() and mf_read_end() see the same even
+    sequence number, otherwise it is simply repeated. Nothing is ever
+    copied or serialized, and a bot never waits for the host.
+
+    Moves go the other way through a ring of commands. A bot may submit
+    as many as fit at once, the host carries out everything that has
+    arrived before it publishes the board again, and only then moves
+    the tail past them. So once nothing is pending, the board shows the
+    result of every move submitted so far.
+
+    One bot per segment, the ring has a single producer.
+
+===========================================================
+*/
+typedef struct mf_shared_t
+{
+    // Written once by the host, magic goes last
+    uint32_t        magic;
+    uint32_t        version;
+    uint32_t        ringSize;
+    uint32_t        reserved0[13];
+
+    // The visible board, only consistent between equal even sequence numbers
+    uint32_t        sequence;
+    uint32_t        width;
+    uint32_t        height;
+    uint32_t        mines;
+    int32_t         minesLeft;              // Mines minus flags, as the game shows it
+    uint32_t        state;                  // mf_state_t
+    uint32_t        generation;             // Changes with every new board
+    uint32_t        reserved1[9];
+    uint8_t         tiles[MF_TILE_BYTES];   // Row by row, the low nibble first
+
+    // Commands from index tail to head are waiting for the host
+    uint32_t        head;                   // Written by the bot
+    uint32_t        reserved2[15];
+    uint32_t        tail;                   // Written by the host
+    uint32_t        reserved3[15];
+    mf_command_t    commands[MF_RING_SIZE];
+} mf_shared_t;
+
+typedef struct mf_link_t mf_link_t;
+
+// NULL if no host is running under that name, or it speaks another version. The name may be NULL for the default one
+MF_API mf_link_t *  mf_connect(const char *name);
+MF_API void         mf_disconnect(mf_link_t *link);
+
+MF_API const mf_shared_t *mf_view(const mf_link_t *link);
+
+// Reads between these two are consistent if mf_read_end() returns 1, otherwise they have to be repeated
+MF_API uint32_t     mf_read_begin(const mf_link_t *link);
+MF_API int          mf_read_end(const mf_link_t *link, uint32_t sequence);
+
+// Returns how many commands fit into the ring, the rest have to be submitted again later
+MF_API uint32_t     mf_submit(mf_link_t *link, const mf_command_t *commands, uint32_t count);
+
+// Commands the host hasn't carried out yet
+MF_API uint32_t     mf_pending(const mf_link_t *link);
+
+// Returns 1 once nothing is pending, 0 if the timeout in milliseconds ran out first
+MF_API int          mf_wait(const mf_link_t *link, uint32_t timeout);
+
+static inline int mf_tile(const mf_shared_t *view, uint32_t x, uint32_t y)
+{
+    uint32_t index = y * view->width + x;
+    return (view->tiles[index >> 1] >> ((index & 1) * 4)) & 15;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,273 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Corpus.h"
+
+/*
+===================
+PutBits
+===================
+*/
+static void PutBits(uint8_t *data, uint64_t bit, uint32_t value, int count)
+{
+    for (int i = 0; i < count; i++, bit++)
+        if (value & (1u << i))
+            data[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+}
+
+/*
+===================
+GetBits
+===================
+*/
+static uint32_t GetBits(const uint8_t *data, uint64_t bit, int count)
+{
+    uint32_t value = 0;
+
+    for (int i = 0; i < count; i++, bit++)
+        if (data[bit >> 3] & (1u << (bit & 7)))
+            value |= 1u << i;
+
+    return value;
+}
+
+/*
+===================
+Corpus::Open
+===================
+*/
+bool Corpus::Open(const char *path)
+{
+    Close();
+    file.open(path, std::ios::binary);
+
+    if (!file || !file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+
+    if (header.magic != CORPUS_MAGIC || header.version != CORPUS_VERSION || header.recordBits != static_cast<uint32_t>(RecordBits(header.width * header.height)))
+    {
+        Close();
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    uint64_t size = static_cast<uint64_t>(file.tellg());
+
+    // A damaged header mustn't make the index bigger than the file
+    if (header.index > size || static_cast<uint64_t>(header.chunks) * sizeof(chunk_t) > size - header.index)
+    {
+        Close();
+        return false;
+    }
+
+    index.resize(header.chunks);
+    file.seekg(header.index);
+
+    if (!file.read(reinterpret_cast<char *>(index.data()), index.size() * sizeof(chunk_t)))
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+/*
+===================
+Corpus::Close
+===================
+*/
+void Corpus::Close()
+{
+    if (file.is_open())
+        file.close();
+
+    file.clear();
+    header = {};
+    index.clear();
+}
+
+/*
+===================
+Corpus::Read
+===================
+*/
+bool Corpus::Read(uint64_t board, record_t &record)
+{
+    if (board >= header.boards || !header.chunkBoards || board / header.chunkBoards >= index.size())
+        return false;
+
+    const chunk_t &chunk = index[board / header.chunkBoards];
+    uint64_t slot = board % header.chunkBoards;
+
+    if (slot >= chunk.boards)
+        return false;
+
+    uint64_t first = slot * header.recordBits;
+    uint64_t last = first + header.recordBits;
+    buffer.assign(((last + 7) >> 3) - (first >> 3), 0);
+
+    file.seekg(chunk.offset + (first >> 3));
+
+    if (!file.read(reinterpret_cast<char *>(buffer.data()), buffer.size()))
+    {
+        file.clear();
+        return false;
+    }
+
+    Unpack(buffer.data(), first & 7, header.width * header.height, record);
+    return true;
+}
+
+/*
+===================
+Corpus::RecordBits
+===================
+*/
+int Corpus::RecordBits(int tiles)
+{
+    return tiles + CORPUS_FIELD_BITS * 4 + 1;
+}
+
+/*
+===================
+Corpus::ChunkBytes
+
+Chunks are padded to whole 64-bit words.
+===================
+*/
+size_t Corpus::ChunkBytes(int tiles, int boards)
+{
+    uint64_t bits = static_cast<uint64_t>(RecordBits(tiles)) * boards;
+    return static_cast<size_t>((bits + 63) / 64 * 8);
+}
+
+/*
+===================
+Corpus::Pack
+===================
+*/
+void Corpus::Pack(uint8_t *chunk, int slot, const Board &board, int click, const Metrics &metrics, bool noGuess)
+{
+    uint64_t bit = static_cast<uint64_t>(slot) * RecordBits(board.Size());
+
+    // The chunk starts zeroed, so only mined tiles set their bit
+    for (int i = 0; i < board.Size(); i++)
+        if (board[i].type == Tile::MINED)
+            chunk[(bit + i) >> 3] |= static_cast<uint8_t>(1u << ((bit + i) & 7));
+
+    bit += board.Size();
+    PutBits(chunk, bit, click, CORPUS_FIELD_BITS);
+    PutBits(chunk, bit + CORPUS_FIELD_BITS, metrics.ThreeBV(), CORPUS_FIELD_BITS);
+    PutBits(chunk, bit + CORPUS_FIELD_BITS * 2, metrics.Openings(), CORPUS_FIELD_BITS);
+    PutBits(chunk, bit + CORPUS_FIELD_BITS * 3, metrics.IsolatedNumbers(), CORPUS_FIELD_BITS);
+    PutBits(chunk, bit + CORPUS_FIELD_BITS * 4, noGuess, 1);
+}
+
+/*
+===================
+Corpus::Unpack
+===================
+*/
+void Corpus::Unpack(const uint8_t *data, uint64_t bit, int tiles, record_t &record)
+{
+    record.mined.resize(tiles);
+
+    for (int i = 0; i < tiles; i++)
+        record.mined[i] = (data[(bit + i) >> 3] >> ((bit + i) & 7)) & 1;
+
+    bit += tiles;
+    record.click = GetBits(data, bit, CORPUS_FIELD_BITS);
+    record.threeBV = GetBits(data, bit + CORPUS_FIELD_BITS, CORPUS_FIELD_BITS);
+    record.openings = GetBits(data, bit + CORPUS_FIELD_BITS * 2, CORPUS_FIELD_BITS);
+    record.isolated = GetBits(data, bit + CORPUS_FIELD_BITS * 3, CORPUS_FIELD_BITS);
+    record.noGuess = GetBits(data, bit + CORPUS_FIELD_BITS * 4, 1);
+}
+
+/*
+===================
+CorpusWriter::Create
+===================
+*/
+bool CorpusWriter::Create(const char *path, int width, int height, int mines)
+{
+    file.open(path, std::ios::binary | std::ios::trunc);
+
+    if (!file)
+        return false;
+
+    header = {};
+    header.magic = CORPUS_MAGIC;
+    header.version = CORPUS_VERSION;
+    header.width = width;
+    header.height = height;
+    header.mines = mines;
+    header.chunkBoards = CORPUS_CHUNK_BOARDS;
+    header.recordBits = Corpus::RecordBits(width * height);
+    index.clear();
+
+    // The header is written again once the index is known
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    offset = sizeof(header);
+
+    return static_cast<bool>(file);
+}
+
+/*
+===================
+CorpusWriter::Write
+===================
+*/
+bool CorpusWriter::Write(uint32_t chunk, const uint8_t *data, int boards)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t bytes = Corpus::ChunkBytes(header.width * header.height, boards);
+
+    if (chunk >= index.size())
+        index.resize(chunk + 1, {});
+
+    index[chunk].offset = offset;
+    index[chunk].boards = boards;
+    header.boards += boards;
+
+    file.write(reinterpret_cast<const char *>(data), bytes);
+    offset += bytes;
+
+    return static_cast<bool>(file);
+}
+
+/*
+===================
+CorpusWriter::Finish
+===================
+*/
+bool CorpusWriter::Finish()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    header.chunks = static_cast<uint32_t>(index.size());
+    header.index = offset;
+
+    file.write(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(Corpus::chunk_t));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.close();
+
+    return !file.fail();
+}
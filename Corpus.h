@@ -0,0 +1,136 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Metrics.h"
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#define CORPUS_MAGIC                0x4243464D // "MFCB"
+#define CORPUS_VERSION              1
+#define CORPUS_CHUNK_BOARDS         4096    // Boards per chunk, every chunk but the last one is full
+#define CORPUS_FIELD_BITS           16      // Bits per number in a record
+
+/*
+===========================================================
+
+    Corpus
+
+    A large set of generated boards of the same size, for training and
+    evaluating bots.
+
+    Every board is a fixed-size record of bits: one bit per tile for
+    mines, then the first click, 3BV, openings, isolated numbers and
+    whether it can be solved without guessing. Records are packed
+    back to back into chunks, and chunks can come in any order since
+    the index at the end of the file points to each of them.
+
+    Layout: header, chunks, index.
+
+===========================================================
+*/
+class Corpus
+{
+public:
+
+    struct header_t
+    {
+        uint32_t        magic;
+        uint32_t        version;
+        uint32_t        width;
+        uint32_t        height;
+        uint32_t        mines;
+        uint32_t        chunkBoards;
+        uint32_t        chunks;
+        uint32_t        recordBits;
+        uint64_t        boards;
+        uint64_t        index;          // Offset of the chunk index
+    };
+
+    struct chunk_t
+    {
+        uint64_t        offset;
+        uint32_t        boards;
+        uint32_t        reserved;
+    };
+
+    struct record_t
+    {
+        std::vector<uint8_t> mined;     // One byte per tile for convenience
+        int             click = 0;      // Index of the first clicked tile
+        int             threeBV = 0;
+        int             openings = 0;
+        int             isolated = 0;
+        bool            noGuess = false;
+    };
+
+    bool                Open(const char *path);
+    void                Close();
+
+    const header_t &    Header() const { return header; }
+    uint64_t            Boards() const { return header.boards; }
+
+    // Random access, reads just the bytes of this record
+    bool                Read(uint64_t board, record_t &record);
+
+    static int          RecordBits(int tiles);
+    static size_t       ChunkBytes(int tiles, int boards);
+
+    // The chunk has to be zeroed first, the board has to be generated
+    static void         Pack(uint8_t *chunk, int slot, const Board &board, int click, const Metrics &metrics, bool noGuess);
+    static void         Unpack(const uint8_t *data, uint64_t bit, int tiles, record_t &record);
+
+private:
+
+    std::ifstream       file;
+    header_t            header = {};
+    std::vector<chunk_t> index;
+    std::vector<uint8_t> buffer;
+};
+
+/*
+===========================================================
+
+    CorpusWriter
+
+    Appends chunks to a corpus file as they are finished. Chunks may be
+    written from several threads and in any order.
+
+===========================================================
+*/
+class CorpusWriter
+{
+public:
+
+    bool                Create(const char *path, int width, int height, int mines);
+    bool                Write(uint32_t chunk, const uint8_t *data, int boards);
+    bool                Finish();
+
+private:
+
+    std::ofstream       file;
+    Corpus::header_t    header = {};
+    std::vector<Corpus::chunk_t> index;
+    std::mutex          mutex;
+    uint64_t            offset = 0;
+};
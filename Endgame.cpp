@@ -0,0 +1,413 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Endgame.h"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+#include <utility>
+
+/*
+===================
+Endgame::Search
+===================
+*/
+bool Endgame::Search(const Board &board, const Solver &solver, result_t &result)
+{
+    result = result_t();
+
+    if (!board.IsGenerated() || board.State() != Board::PLAYING)
+        return false;
+
+    outOfTime = false;
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeBudget);
+
+    if (!ListLayouts(board, solver) || layouts.empty())
+        return false;
+
+    for (shard_t &shard : table)
+        shard.positions.clear();
+
+    result.layouts = static_cast<int>(layouts.size());
+
+    int count = static_cast<int>(unknowns.size());
+    std::vector<std::pair<int, int>> candidates;
+
+    for (int t = 0; t < count; t++)
+    {
+        int safe = SafeCount(layouts, t);
+
+        if (safe)
+            candidates.emplace_back(safe, t);
+    }
+
+    if (candidates.empty())
+        return false;
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    // A tile that is safe in every layout costs nothing to open
+    if (candidates[0].first == static_cast<int>(layouts.size()))
+    {
+        result.tile = unknowns[candidates[0].second];
+        result.winProbability = Win(layouts, 0);
+        result.exact = !outOfTime;
+    }
+    else
+    {
+        std::vector<float> values(candidates.size(), -1.0f);
+        std::atomic<int> next = 0;
+        std::mutex bestMutex;
+        float best = 0.0f;
+
+        auto worker = [&]()
+        {
+            for (int i = next++; i < static_cast<int>(candidates.size()); i = next++)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(bestMutex);
+
+                    // Even surviving this guess can't beat the best one
+                    if (static_cast<float>(candidates[i].first) / layouts.size() <= best)
+                        continue;
+                }
+
+                float value = Guess(layouts, 0, candidates[i].second);
+
+                if (outOfTime)
+                    return;
+
+                values[i] = value;
+                std::lock_guard<std::mutex> lock(bestMutex);
+                best = std::max(best, value);
+            }
+        };
+
+        int threadCount = threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        std::vector<std::thread> pool;
+
+        for (int i = 1; i < threadCount; i++)
+            pool.emplace_back(worker);
+
+        worker();
+
+        for (std::thread &thread : pool)
+            thread.join();
+
+        // The safest guess if nothing has been searched in time
+        result.tile = unknowns[candidates[0].second];
+        result.winProbability = -1.0f;
+
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            if (values[i] > result.winProbability)
+            {
+                result.tile = unknowns[candidates[i].second];
+                result.winProbability = values[i];
+            }
+        }
+
+        if (result.winProbability < 0.0f)
+            result.winProbability = static_cast<float>(candidates[0].first) / layouts.size();
+
+        result.exact = !outOfTime;
+    }
+
+    for (shard_t &shard : table)
+        result.positions += shard.positions.size();
+
+    return true;
+}
+
+/*
+===================
+Endgame::ListLayouts
+
+Every way to place the remaining mines into the unknown tiles that fits the numbers.
+===================
+*/
+bool Endgame::ListLayouts(const Board &board, const Solver &solver)
+{
+    unknowns.clear();
+    layouts.clear();
+
+    std::vector<int> local(board.Size(), -1);
+
+    // Tiles next to numbers go first, the rest is only bound by the mine count and never leads to a dead end
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < board.Size(); i++)
+        {
+            if (solver.Knowledge(i) != Solver::UNKNOWN || IsNextToNumber(board, i) != !pass)
+                continue;
+
+            if (static_cast<int>(unknowns.size()) >= maxUnknowns || static_cast<int>(unknowns.size()) >= 64)
+                return false;
+
+            local[i] = static_cast<int>(unknowns.size());
+            unknowns.push_back(i);
+        }
+    }
+
+    int count = static_cast<int>(unknowns.size());
+    neighbors.assign(count, 0);
+
+    // Numbers as masks of the unknown tiles around them
+    std::vector<uint64_t> numberMasks;
+    std::vector<int> numberNeed;
+
+    for (int i = 0; i < board.Size(); i++)
+    {
+        const Tile &tile = board[i];
+        bool isNumber = tile.state == Tile::OPEN && tile.type != Tile::MINED;
+        uint64_t mask = 0;
+        int need = tile.nearestMines;
+
+        for (int y = board.Y(i) - 1; y <= board.Y(i) + 1; y++)
+        {
+            for (int x = board.X(i) - 1; x <= board.X(i) + 1; x++)
+            {
+                if (!board.IsInside(x, y))
+                    continue;
+
+                int neighbor = board.Index(x, y);
+
+                if (local[neighbor] >= 0)
+                    mask |= 1ull << local[neighbor];
+                else if (solver.Knowledge(neighbor) == Solver::MINE)
+                    need--;
+            }
+        }
+
+        if (local[i] >= 0)
+            neighbors[local[i]] = mask & ~(1ull << local[i]);
+
+        if (isNumber && mask)
+        {
+            numberMasks.push_back(mask);
+            numberNeed.push_back(need);
+        }
+    }
+
+    int mines = solver.UnknownMines();
+
+    // Depth first, cutting branches that already break a number or the mine count
+    std::vector<uint64_t> stack = { 0 };
+    std::vector<int> depths = { 0 };
+
+    for (int steps = 0; !stack.empty(); steps++)
+    {
+        // Numbers that only contradict each other deep down can take a while
+        if (!(steps & 4095) && IsOutOfTime())
+            return false;
+
+        uint64_t layout = stack.back();
+        int depth = depths.back();
+        stack.pop_back();
+        depths.pop_back();
+
+        uint64_t assigned = depth == 64 ? ~0ull : (1ull << depth) - 1;
+        int placed = std::popcount(layout);
+        bool valid = placed <= mines && placed + (count - depth) >= mines;
+
+        for (size_t n = 0; n < numberMasks.size() && valid; n++)
+        {
+            int mined = std::popcount(numberMasks[n] & layout);
+            int open = std::popcount(numberMasks[n] & ~assigned);
+
+            if (mined > numberNeed[n] || mined + open < numberNeed[n])
+                valid = false;
+        }
+
+        if (!valid)
+            continue;
+
+        if (depth == count)
+        {
+            if (static_cast<int>(layouts.size()) >= maxLayouts)
+                return false;
+
+            layouts.push_back(layout);
+            continue;
+        }
+
+        stack.push_back(layout | (1ull << depth));
+        depths.push_back(depth + 1);
+        stack.push_back(layout);
+        depths.push_back(depth + 1);
+    }
+
+    return true;
+}
+
+/*
+===================
+Endgame::IsNextToNumber
+===================
+*/
+bool Endgame::IsNextToNumber(const Board &board, int index) const
+{
+    for (int y = board.Y(index) - 1; y <= board.Y(index) + 1; y++)
+        for (int x = board.X(index) - 1; x <= board.X(index) + 1; x++)
+            if (board.IsInside(x, y) && board.At(x, y).state == Tile::OPEN)
+                return true;
+
+    return false;
+}
+
+/*
+===================
+Endgame::Win
+
+The chance of winning from here with the best play.
+===================
+*/
+float Endgame::Win(const std::vector<uint64_t> &layouts, uint64_t revealed)
+{
+    if (layouts.size() == 1)
+        return 1.0f;
+
+    if (IsOutOfTime())
+        return 0.0f;
+
+    // The layouts alone decide the outcome, opened tiles are safe in all of them and tell nothing new.
+    // They are always a subsequence of the full list, so hashing them in order is enough.
+    uint64_t key = 0x9E3779B97F4A7C15ull;
+
+    for (uint64_t layout : layouts)
+        key = (key ^ layout) * 0xBF58476D1CE4E5B9ull + (key >> 29);
+
+    shard_t &shard = table[key % ENDGAME_TABLE_SHARDS];
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.positions.find(key);
+
+        if (it != shard.positions.end())
+            return it->second;
+    }
+
+    int count = static_cast<int>(unknowns.size());
+    uint64_t all = count == 64 ? ~0ull : (1ull << count) - 1;
+    uint64_t mined = 0;
+
+    for (uint64_t layout : layouts)
+        mined |= layout;
+
+    uint64_t free = all & ~mined & ~revealed;
+    float value = 0.0f;
+
+    if (free)
+    {
+        value = Guess(layouts, revealed, std::countr_zero(free));
+    }
+    else
+    {
+        std::vector<std::pair<int, int>> candidates;
+
+        for (int t = 0; t < count; t++)
+        {
+            if (revealed & (1ull << t))
+                continue;
+
+            int safe = SafeCount(layouts, t);
+
+            if (safe)
+                candidates.emplace_back(safe, t);
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+        for (const auto &candidate : candidates)
+        {
+            // Sorted by safety, so no later guess can beat the best one either
+            if (static_cast<float>(candidate.first) / layouts.size() <= value)
+                break;
+
+            value = std::max(value, Guess(layouts, revealed, candidate.second));
+
+            if (value >= 1.0f || outOfTime)
+                break;
+        }
+    }
+
+    if (!outOfTime)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.positions[key] = value;
+    }
+
+    return value;
+}
+
+/*
+===================
+Endgame::Guess
+
+Opens a tile and splits the layouts where it's safe by the number it shows.
+===================
+*/
+float Endgame::Guess(const std::vector<uint64_t> &layouts, uint64_t revealed, int tile)
+{
+    uint64_t bit = 1ull << tile;
+    std::vector<uint64_t> groups[9];
+
+    for (uint64_t layout : layouts)
+        if (!(layout & bit))
+            groups[std::popcount(layout & neighbors[tile])].push_back(layout);
+
+    float wins = 0.0f;
+
+    for (const std::vector<uint64_t> &group : groups)
+        if (!group.empty())
+            wins += group.size() * Win(group, revealed | bit);
+
+    return wins / layouts.size();
+}
+
+/*
+===================
+Endgame::SafeCount
+===================
+*/
+int Endgame::SafeCount(const std::vector<uint64_t> &layouts, int tile) const
+{
+    uint64_t bit = 1ull << tile;
+    int safe = 0;
+
+    for (uint64_t layout : layouts)
+        if (!(layout & bit))
+            safe++;
+
+    return safe;
+}
+
+/*
+===================
+Endgame::IsOutOfTime
+===================
+*/
+bool Endgame::IsOutOfTime()
+{
+    if (!outOfTime && std::chrono::steady_clock::now() > deadline)
+        outOfTime = true;
+
+    return outOfTime;
+}
@@ -0,0 +1,98 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Solver.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#define ENDGAME_MAX_UNKNOWNS        64
+#define ENDGAME_MAX_LAYOUTS         20000
+#define ENDGAME_TIME_BUDGET         250     // Milliseconds
+#define ENDGAME_TABLE_SHARDS        64
+
+/*
+===========================================================
+
+    Endgame
+
+    Finds the guess with the best chance of winning the whole game, not
+    just of surviving the next click.
+
+    Once there are few enough unknown tiles, every mine layout that fits
+    the numbers is listed. A position is the set of layouts still possible,
+    a guess splits it by the number the tile would show. Positions reached
+    in different orders are shared through a transposition table, and a
+    guess is skipped once even surviving it couldn't beat the best one.
+
+    Guesses at the root are searched on all cores. When the time runs out,
+    the best fully searched guess is returned, or the safest one.
+
+===========================================================
+*/
+class Endgame
+{
+public:
+
+    struct result_t
+    {
+        int             tile = -1;
+        float           winProbability = 0.0f;
+        bool            exact = false;      // The search finished within the time budget
+        int             layouts = 0;
+        size_t          positions = 0;
+    };
+
+    // Returns false if the position is too big to search, the solver has to be up to date with the board
+    bool                Search(const Board &board, const Solver &solver, result_t &result);
+
+    int                 maxUnknowns = ENDGAME_MAX_UNKNOWNS;
+    int                 maxLayouts = ENDGAME_MAX_LAYOUTS;
+    int                 timeBudget = ENDGAME_TIME_BUDGET;
+    int                 threads = 0;        // All cores if 0
+
+private:
+
+    struct shard_t
+    {
+        std::mutex      mutex;
+        std::unordered_map<uint64_t, float> positions;
+    };
+
+    bool                ListLayouts(const Board &board, const Solver &solver);
+    bool                IsNextToNumber(const Board &board, int index) const;
+    float               Win(const std::vector<uint64_t> &layouts, uint64_t revealed);
+    float               Guess(const std::vector<uint64_t> &layouts, uint64_t revealed, int tile);
+    int                 SafeCount(const std::vector<uint64_t> &layouts, int tile) const;
+    bool                IsOutOfTime();
+
+    std::vector<int>    unknowns;           // Board index of every unknown tile
+    std::vector<uint64_t> neighbors;        // Unknown tiles around every unknown tile
+    std::vector<uint64_t> layouts;          // Bit per unknown tile, set for mines
+
+    shard_t             table[ENDGAME_TABLE_SHARDS];
+    std::atomic<bool>   outOfTime = false;
+    std::chrono::steady_clock::time_point deadline;
+};
@@ -19,6 +19,10 @@
 
 #include "Main.h"
 #include "Game.h"
+#include "BoomSheet.h"
+
+#include <algorithm>
+#include <ctime>
 
 const char *controls = "Mouse:\n"
                        "LMB - Open a tile\n"
@@ -35,6 +39,11 @@ const char *controls = "Mouse:\n"
                        "F2 - Controls\n"
                        "F3 - Settings\n"
                        "F4 - Turn on/off sound\n"
+                       "F5 - Show/hide mine probabilities\n"
+                       "F6 - Show the code of this board\n"
+                       "F7 - Type in a board code\n"
+                       "F8 - Watch the last game, 1-5 for its speed, 0 to pause, comma/period to seek\n"
+                       "F9 - Turn on/off practice, Z/Y to undo/redo a move\n"
                        "F12 - Take a screenshot";
 
 const char *help = "The rules are simple: click on a tile to reveal what's underneath.\n"
@@ -55,6 +64,25 @@ Game::Init
 */
 bool Game::Init()
 {
+    startupStart = std::chrono::steady_clock::now();
+    uint64_t seed = static_cast<uint64_t>(startupStart.time_since_epoch().count());
+    pool.seed = seed + 1;
+    heatmap.seed = seed + 2;
+    seeds = Random(seed, 3);
+
+    // Warms up the file cache for everything, including resources that are loaded later
+    std::vector<libStr> prefetch = { DATA_PACK "Textures/Panel.tga", DATA_PACK "Textures/Scoreboard.tga",
+                                     DATA_PACK "Textures/Smile.tga", DATA_PACK "Textures/SmileClick.tga",
+                                     DATA_PACK "Textures/SmileWon.tga", DATA_PACK "Textures/SmileLost.tga",
+                                     DATA_PACK "Textures/Tile.tga", DATA_PACK "Textures/TileOpen.tga",
+                                     DATA_PACK "Textures/Mine.tga", DATA_PACK "Textures/Flag.tga",
+                                     DATA_PACK "Textures/Question.tga", DATA_PACK "Textures/InputField.tga",
+                                     DATA_PACK "Textures/SoundOn.tga", DATA_PACK "Textures/SoundOff.tga",
+                                     DATA_PACK "Textures/BoomSheet.tga", DATA_PACK "Font.ttf",
+                                     DATA_PACK "Digital.ttf", DATA_PACK "Sounds/Boom.wav" };
+
+    assets.Prefetch(prefetch);
+
     engine->Get(mesh_smile.Get());
     engine->Get(mesh_scoreboard.Get());
     engine->Get(mesh_tile.Get());
@@ -64,22 +92,23 @@ bool Game::Init()
     engine->Get(mesh_flag.Get());
     engine->Get(mesh_panel.Get());
     engine->Get(mesh_lines.Get());
-
-    LIB_CHECK(engine->Get(tex_panel.Get(), DATA_PACK "Textures/Panel.tga"));
-    LIB_CHECK(engine->Get(tex_scoreboard.Get(), DATA_PACK "Textures/Scoreboard.tga"));
-    LIB_CHECK(engine->Get(tex_smile.Get(), DATA_PACK "Textures/Smile.tga"));
-    LIB_CHECK(engine->Get(tex_smileClick.Get(), DATA_PACK "Textures/SmileClick.tga"));
-    LIB_CHECK(engine->Get(tex_smileWin.Get(), DATA_PACK "Textures/SmileWon.tga"));
-    LIB_CHECK(engine->Get(tex_smileLost.Get(), DATA_PACK "Textures/SmileLost.tga"));
-    LIB_CHECK(engine->Get(tex_tile.Get(), DATA_PACK "Textures/Tile.tga"));
-    LIB_CHECK(engine->Get(tex_tileOpen.Get(), DATA_PACK "Textures/TileOpen.tga"));
-    LIB_CHECK(engine->Get(tex_mine.Get(), DATA_PACK "Textures/Mine.tga"));
-    LIB_CHECK(engine->Get(tex_flag.Get(), DATA_PACK "Textures/Flag.tga"));
-    LIB_CHECK(engine->Get(tex_question.Get(), DATA_PACK "Textures/Question.tga"));
-    LIB_CHECK(engine->Get(spr_boom.Get(), DATA_PACK "Textures/Boom/Boom.tga"));
-    LIB_CHECK(engine->Get(font.Get(), DATA_PACK "Font.ttf"));
-    LIB_CHECK(engine->Get(digital.Get(), DATA_PACK "Digital.ttf"));
-    LIB_CHECK(engine->Get(snd_boom.Get(), DATA_PACK "Sounds/Boom.wav"));
+    engine->Get(mesh_boom.Get());
+    engine->Get(mesh_heatmap.Get());
+
+    // Only what the first frame needs, the explosion and the settings screen are loaded later
+    LIB_CHECK(assets.Get(tex_panel, DATA_PACK "Textures/Panel.tga"));
+    LIB_CHECK(assets.Get(tex_scoreboard, DATA_PACK "Textures/Scoreboard.tga"));
+    LIB_CHECK(assets.Get(tex_smile, DATA_PACK "Textures/Smile.tga"));
+    LIB_CHECK(assets.Get(tex_smileClick, DATA_PACK "Textures/SmileClick.tga"));
+    LIB_CHECK(assets.Get(tex_smileWin, DATA_PACK "Textures/SmileWon.tga"));
+    LIB_CHECK(assets.Get(tex_smileLost, DATA_PACK "Textures/SmileLost.tga"));
+    LIB_CHECK(assets.Get(tex_tile, DATA_PACK "Textures/Tile.tga"));
+    LIB_CHECK(assets.Get(tex_tileOpen, DATA_PACK "Textures/TileOpen.tga"));
+    LIB_CHECK(assets.Get(tex_mine, DATA_PACK "Textures/Mine.tga"));
+    LIB_CHECK(assets.Get(tex_flag, DATA_PACK "Textures/Flag.tga"));
+    LIB_CHECK(assets.Get(tex_question, DATA_PACK "Textures/Question.tga"));
+    LIB_CHECK(assets.Get(font, DATA_PACK "Font.ttf"));
+    LIB_CHECK(assets.Get(digital, DATA_PACK "Digital.ttf"));
 
     font->SetAlign(LIB_CENTER);
     font->SetShadowType(libFont::SHADOW_ADDAPTIVE);
@@ -88,9 +117,6 @@ bool Game::Init()
     digital->SetSize(28);
     digital->SetAlign(LIB_CENTER);
 
-    spr_boom->SetDuration(BOOM_DURATION);
-    spr_boom->SetStyle(libSprite::ONCE);
-
     tex_curSmile = tex_smile;
 
     buttonRestart.SetSize(TILE_SIZE * 2, TILE_SIZE * 2);
@@ -112,6 +138,36 @@ bool Game::Init()
     mineRatio = cfg.GetFloat("AutoMineRatio", DEFAULT_MINE_RATIO);
     autoFieldSize.x = cfg.GetInt("AutoFieldWidth", DEFAULT_AUTO_FIELD_WIDTH);
     autoFieldSize.y = cfg.GetInt("AutoFieldHeight", DEFAULT_AUTO_FIELD_HEIGHT);
+    autoDifficulty.belief.skill = cfg.GetFloat("AutoSkill", AUTO_SKILL_PRIOR);
+    autoDifficulty.belief.skillVariance = cfg.GetFloat("AutoSkillVariance", AUTO_SKILL_VARIANCE);
+    autoDifficulty.belief.speed = cfg.GetFloat("AutoSpeed", AUTO_SPEED_PRIOR);
+    autoDifficulty.belief.speedVariance = cfg.GetFloat("AutoSpeedVariance", AUTO_SPEED_VARIANCE);
+    // Config values are 32-bit, so a seed is split into its low and high halves
+    boardSeed = (static_cast<uint64_t>(static_cast<uint32_t>(cfg.GetInt("BoardSeedHigh", 0))) << 32 |
+                 static_cast<uint32_t>(cfg.GetInt("BoardSeed", 0))) & BOARD_CODE_SEED_MASK;
+    heatmapShown = cfg.GetBool("Heatmap", false);
+    practice = cfg.GetBool("Practice", false);
+
+    libStr historyPath;
+    libDir::GetLocalDataLocation(historyPath);
+    historyPath.Append("/Minefield/History.dat");
+    history.Open(historyPath.Get());
+
+    libStr replayPath;
+    libDir::GetLocalDataLocation(replayPath);
+    replayPath.Append("/Minefield/Replays");
+    libDir::Create(replayPath.Get());
+    recorder.SetDirectory(replayPath.Get());
+
+    libStr snapshotPath;
+    libDir::GetLocalDataLocation(snapshotPath);
+    snapshotPath.Append("/Minefield/Game.dat");
+    autosave.SetPath(snapshotPath.Get());
+
+    recordBots = cfg.GetBool("BotLinkRecord", false);
+
+    if (cfg.GetBool("BotLink", false) && !botHost.Open())
+        libDialog::Error("Couldn't start BotLink", botHost.Error());
 
     engine->SetState(LIB_AUDIO_VOLUME, cfg.GetFloat("AudioVolume", DEFAULT_AUDIO_VOLUME));
 
@@ -119,6 +175,7 @@ bool Game::Init()
 
     ClampFieldDimensions();
     Restart();
+    ResumeGame(snapshotPath.Get());
     UpdatePanelsMesh();
 
     return true;
@@ -134,9 +191,16 @@ void Game::Draw()
     if (updateTilesMesh)
     {
         updateTilesMesh = false;
+        updateHeatmapMesh = true;
         UpdateTilesMesh();
     }
 
+    if (updateHeatmapMesh)
+    {
+        updateHeatmapMesh = false;
+        UpdateHeatmapMesh();
+    }
+
     libVec2i screenSize(engine->State(LIB_SCREEN_WIDTH), engine->State(LIB_SCREEN_HEIGHT));
 
     engine->Draw(mesh_panel.Get(), tex_panel.Get(), true);
@@ -177,6 +241,7 @@ void Game::Draw()
     engine->Draw(mesh_scoreboard.Get(), tex_scoreboard.Get(), true);
     engine->Draw(mesh_tile.Get(), tex_tile.Get(), true);
     engine->Draw(mesh_tileOpen.Get(), tex_tileOpen.Get(), true);
+    engine->Draw(mesh_heatmap.Get(), nullptr, true);
     engine->Draw(mesh_mine.Get(), tex_mine.Get(), true);
     engine->Draw(mesh_question.Get(), tex_question.Get(), true);
     engine->Draw(mesh_flag.Get(), tex_flag.Get(), true);
@@ -189,7 +254,7 @@ void Game::Draw()
 
     // The font doesn't appear to be exactly in the center, so this corrects that
     float digitalFontOffset = -1.0f;
-    int printableMinesLeft = shownMinesLeft;
+    int printableMinesLeft = board.ShownMinesLeft();
 
     if (printableMinesLeft < SCOREBOARD_MIN_VALUE)
         printableMinesLeft = SCOREBOARD_MIN_VALUE;
@@ -205,13 +270,35 @@ void Game::Draw()
     digital->Print2D(sbPos.x, sbPos.y + digitalFontOffset, "%03d", printableMinesLeft);
     digital->Print2D(sbPos2.x, sbPos2.y + digitalFontOffset, "%03d", gameTime > SCOREBOARD_MAX_VALUE ? SCOREBOARD_MAX_VALUE : gameTime);
 
+    // 3BV per second under the mine counter and click efficiency under the timer
+    if (gameState == WON)
+    {
+        float seconds = libCast<float>(PlayedSeconds());
+        int clicks = leftClicks + rightClicks + chordClicks;
+
+        if (seconds < 0.001f)
+            seconds = 0.001f;
+
+        if (!clicks)
+            clicks = 1;
+
+        float statsY = sbPos.y + scoreboardSize.y / 2.0f + halfTile;
+
+        font->SetColor(LIB_COLOR_BLACK);
+        font->SetSize(libCast<int>(TILE_SIZE / 2) - 1);
+        font->SetShadowType(libFont::NO_SHADOW);
+        font->Print2D(sbPos.x, statsY, "%.2f 3BV/s", metrics.ThreeBV() / seconds);
+        font->Print2D(sbPos2.x, statsY, "%d%%", libCast<int>(100.0f * metrics.ThreeBV() / clicks));
+        font->SetShadowType(shadowType);
+    }
+
     for (int i = 0; i < fieldSize.x; i++)
     {
         for (int j = 0; j < fieldSize.y; j++)
         {
             float x = p2Offset.x + libCast<float>(TILE_SIZE * i) - 1; // Minus 1 for fixing a small gap on the left side
             float y = p2Offset.y + libCast<float>(TILE_SIZE * j);
-            Tile &tile = field[i][j];
+            const Tile &tile = board.At(i, j);
 
             // Number of the nearest mines around a tile
             if (tile.type != Tile::MINED && tile.state == Tile::OPEN)
@@ -243,11 +330,44 @@ void Game::Draw()
     }
 
     // Mine explosion
-    if (gameState == LOST && spr_boom->IsPlaying())
+    if (gameState == LOST && IsBoomPlaying())
+    {
+        UpdateBoomMesh();
+        engine->Draw(mesh_boom.Get(), tex_boom.Get(), true);
+    }
+
+    if (watching)
+    {
+        font->SetColor(LIB_COLOR_BLACK);
+        font->SetSize(libCast<int>(TILE_SIZE / 2));
+
+        if (replaySpeed)
+            font->Print2D(p2Offset.x + fieldSize.x * halfTile, p2Offset.y + fieldSize.y * TILE_SIZE - halfTile, "Replay %dx", replaySpeed);
+        else
+            font->Print2D(p2Offset.x + fieldSize.x * halfTile, p2Offset.y + fieldSize.y * TILE_SIZE - halfTile, "Replay paused");
+    }
+    else if (practice)
     {
-        libQuad q_boom(libVertex(-BOOM_RATIUS, -BOOM_RATIUS, 0.0f, 0.0f), libVertex(BOOM_RATIUS, BOOM_RATIUS, 1.0f, 1.0f));
-        spr_boom->Draw2DQuad(q_boom, boomCoord.x, boomCoord.y);
+        font->SetColor(LIB_COLOR_BLACK);
+        font->SetSize(libCast<int>(TILE_SIZE / 2));
+        font->Print2D(p2Offset.x + fieldSize.x * halfTile, p2Offset.y + fieldSize.y * TILE_SIZE - halfTile, "Practice");
+    }
+
+    // A board code being typed in, over the middle of the field
+    if (enteringCode)
+    {
+        std::string code;
+
+        for (size_t i = 0; i < typedCode.size(); i++)
+            code += (i && !(i % 4) ? "-" : "") + typedCode.substr(i, 1);
+
+        font->SetColor(typedCode.size() == BOARD_CODE_SYMBOLS ? LIB_COLOR_RED : LIB_COLOR_BLACK);
+        font->SetSize(TILE_SIZE);
+        font->Print2D(p2Offset.x + fieldSize.x * halfTile, p2Offset.y + fieldSize.y * halfTile, "Code: %s", code.c_str());
     }
+
+    if (!framesDrawn++)
+        cfg.SetFloat("StartupTime", std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startupStart).count());
 }
 
 /*
@@ -257,6 +377,10 @@ Game::Update
 */
 void Game::Update()
 {
+    // Everything the first frame didn't need is loaded once it has been shown
+    if (framesDrawn && !deferredTried)
+        LoadDeferred();
+
     if (engine->IsKeyPressed(LIBK_F1))
         ShowHelp();
     
@@ -269,13 +393,39 @@ void Game::Update()
     if (engine->IsKeyPressed(LIBK_F4))
         ToggleAudio();
 
+    if (engine->IsKeyPressed(LIBK_F5))
+        ToggleHeatmap();
+
+    if (engine->IsKeyPressed(LIBK_F6))
+        ShowBoardCode();
+
+    if (engine->IsKeyPressed(LIBK_F7))
+        ToggleCodeEntry();
+
+    if (engine->IsKeyPressed(LIBK_F8))
+        WatchReplay();
+
+    if (engine->IsKeyPressed(LIBK_F9))
+        TogglePractice();
+
+    // Whatever the worker has finished by now, the last result stays on screen until then
+    if (heatmapShown && heatmap.Fetch(heatmapProbabilities))
+        updateHeatmapMesh = true;
+
     if (settingsShown)
     {
         settings.Update();
         return;
     }
 
-    gameTime = libCast<int>(timer.Seconds());
+    // The field doesn't take clicks while a code is typed in
+    if (enteringCode)
+    {
+        TypeBoardCode();
+        return;
+    }
+
+    gameTime = libCast<int>(PlayedSeconds());
 
     buttonRestart.Update();
     buttonSettings.Update();
@@ -294,11 +444,43 @@ void Game::Update()
     else
         buttonSettings.SetTexture(tex_tile.Get());
         
+    if (watching)
+    {
+        UpdateReplay();
+        return;
+    }
+
+    if (practice)
+        UpdatePractice();
+
+    // A first click that waits for its no-guess board opens the tile once the pool has it
+    if (openPending && gameState == PLAYING)
+    {
+        int x = pendingOpen.x;
+        int y = pendingOpen.y;
+
+        if (!board.At(x, y).CanOpen())
+            openPending = false;
+        else if (GenerateBoard(x, y))
+        {
+            openPending = false;
+            timer.Start();
+            leftClicks++;
+            RecordAction(Replay::OPEN, x, y);
+            board.Open(x, y);
+            ApplyBoardChanges();
+        }
+    }
+
     if (gameState == PLAYING)
         UpdateTiles();
 
+    // Moves of external bots, and the board for them to see afterwards. The changes are applied once for all of them.
+    if (botHost.Poll(board, [this](const mf_command_t &command) { ApplyBotCommand(command); }))
+        ApplyBoardChanges();
+
     // Sets the smile button to its default state when a tile is not being pressed
-    if (gameState == PLAYING)
+    if (gameState == PLAYING && !openPending)
         if (!LeftPressing() && !MiddlePressing())
             tex_curSmile = tex_smile;
 }
@@ -310,52 +492,83 @@ Game::Restart
 */
 void Game::Restart()
 {
-    if (settings.Difficulty() == Settings::BEGINNER)
-    {
-        fieldSize.Set(10, 10);
-        minesLeft = 10;
-    }
-    else if (settings.Difficulty() == Settings::INTERMEDIATE)
-    {
-        fieldSize.Set(16, 16);
-        minesLeft = 40;
-    }
-    else if (settings.Difficulty() == Settings::EXPERT)
-    {
-        fieldSize.Set(30, 16);
-        minesLeft = 99;
-    }
-    else if (settings.Difficulty() == Settings::AUTO)
-    {
-        fieldSize = autoFieldSize;
-        minesLeft = libCast<int>(fieldSize.x * fieldSize.y * mineRatio);
-    }
-    else if (settings.Difficulty() == Settings::CUSTOM)
+    int mines = 0;
+
+    AbandonGame();
+    watching = false;
+
+    DifficultyField(fieldSize, mines);
+
+    // A board code overrides the difficulty for one game
+    if (codePending)
     {
-        fieldSize.Set(settings.CustomWidth(), settings.CustomHeight());
-        minesLeft = settings.CustomMines();
+        fieldSize.Set(pendingCode.width, pendingCode.height);
+        mines = pendingCode.mines;
     }
 
-    if (minesLeft >= fieldSize.x * fieldSize.y)
-        minesLeft = fieldSize.x * fieldSize.y - 1;
+    board.Reset(fieldSize.x, fieldSize.y, mines);
+    boardChanges = 0;
+    moves.Clear();
 
-    for (int i = 0; i < fieldSize.x; i++)
-    {
-        for (int j = 0; j < fieldSize.y; j++)
-        {
-            Tile &tile = field[i][j];
+    // Moves can be undone in practice, which a replay has no way to show
+    if (!practice)
+        recorder.Start(fieldSize.x, fieldSize.y, mines, FieldDifficulty());
 
-            tile.button.SetTexture(tex_tile.Get());
-            tile.Reset();
-        }
-    }
+    // Ordinary boards come from the seed of the game, only no-guess boards are searched for in advance
+    if (settings.NoGuess() && !codePending)
+        pool.Start(board);
+
+    // Also cancels whatever the worker is still computing for the previous board
+    heatmapProbabilities.clear();
+
+    if (heatmapShown)
+        heatmap.Request(board);
+
+    ResetButtons();
 
     gameTime = 0;
+    leftClicks = rightClicks = chordClicks = 0;
     gameState = PLAYING;
     timer.Reset();
-    spr_boom->Reset();
-    firstClick = true;
-    shownMinesLeft = minesLeft;
+    resumedSeconds = 0.0;
+    movesSinceSave = 0;
+    openPending = false;
+    botGame = false;
+
+    boomTimer.Reset();
+
+    do
+        gameSeed = seeds.Next() & BOARD_CODE_SEED_MASK;
+    while (!gameSeed);
+
+    // A board code, or a seed found by MinefieldSeedSearch, is played once with its first tile already open
+    if (codePending || boardSeed)
+    {
+        if (codePending)
+        {
+            gameSeed = pendingCode.seed;
+            firstClick.Set(pendingCode.x, pendingCode.y);
+        }
+        else
+        {
+            gameSeed = boardSeed;
+            firstClick.Set(Generator::SeedX(board), Generator::SeedY(board));
+        }
+
+        Generator::FromSeed(board, gameSeed, firstClick.x, firstClick.y);
+        metrics.Compute(board);
+        recorder.SetBoard(board, gameSeed);
+        timer.Start();
+        RecordAction(Replay::OPEN, firstClick.x, firstClick.y);
+        board.Open(firstClick.x, firstClick.y);
+        ApplyBoardChanges();
+
+        codePending = false;
+        boardSeed = 0;
+        cfg.SetInt("BoardSeed", 0);
+        cfg.SetInt("BoardSeedHigh", 0);
+    }
+
     AdjustWindowSize();
     UpdatePanelsMesh();
     updateTilesMesh = true;
@@ -372,6 +585,12 @@ void Game::SaveSettings()
     cfg.SetFloat("AutoMineRatio", mineRatio);
     cfg.SetInt("AutoFieldWidth", autoFieldSize.x);
     cfg.SetInt("AutoFieldHeight", autoFieldSize.y);
+    cfg.SetFloat("AutoSkill", autoDifficulty.belief.skill);
+    cfg.SetFloat("AutoSkillVariance", autoDifficulty.belief.skillVariance);
+    cfg.SetFloat("AutoSpeed", autoDifficulty.belief.speed);
+    cfg.SetFloat("AutoSpeedVariance", autoDifficulty.belief.speedVariance);
+    cfg.SetBool("Heatmap", heatmapShown);
+    cfg.SetBool("Practice", practice);
 
     cfg.Save();
 }
@@ -394,6 +613,9 @@ Game::ToggleSettings
 */
 void Game::ToggleSettings()
 {
+    if (!settingsShown && !settings.Load())
+        return;
+
     settingsShown = !settingsShown;
     AdjustWindowSize();
     UpdatePanelsMesh();
@@ -412,6 +634,96 @@ void Game::ToggleAudio()
         engine->SetState(LIB_AUDIO_VOLUME, DEFAULT_AUDIO_VOLUME);
 }
 
+/*
+===================
+Game::ToggleHeatmap
+===================
+*/
+void Game::ToggleHeatmap()
+{
+    heatmapShown = !heatmapShown;
+    heatmapProbabilities.clear();
+    updateHeatmapMesh = true;
+
+    if (heatmapShown)
+        heatmap.Request(board);
+}
+
+/*
+===================
+Game::TogglePractice
+
+Starts a new game, a game is either practice or not from beginning to end.
+===================
+*/
+void Game::TogglePractice()
+{
+    practice = !practice;
+    Restart();
+}
+
+/*
+===================
+Game::LoadDeferred
+
+Loads resources that are not needed for the first frame.
+===================
+*/
+bool Game::LoadDeferred()
+{
+    if (deferredTried)
+        return deferredLoaded;
+
+    deferredTried = true;
+    auto start = std::chrono::steady_clock::now();
+
+    LIB_CHECK(assets.Get(tex_boom, DATA_PACK "Textures/BoomSheet.tga"));
+    LIB_CHECK(assets.Get(snd_boom, DATA_PACK "Sounds/Boom.wav"));
+
+    cfg.SetFloat("DeferredLoadTime", std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+    deferredLoaded = true;
+
+    return true;
+}
+
+/*
+===================
+Game::IsBoomPlaying
+===================
+*/
+bool Game::IsBoomPlaying() const
+{
+    return deferredLoaded && boomTimer.Seconds() > 0.0f && boomTimer.Seconds() * 1000.0f < BOOM_DURATION;
+}
+
+/*
+===================
+Game::UpdateBoomMesh
+
+The explosion is a single sprite sheet, every frame is a trimmed rectangle of it.
+===================
+*/
+void Game::UpdateBoomMesh()
+{
+    int frame = libCast<int>(boomTimer.Seconds() * 1000.0f / BOOM_DURATION * BOOM_FRAMES);
+
+    if (frame >= BOOM_FRAMES)
+        frame = BOOM_FRAMES - 1;
+
+    const int *rect = boomSheetFrames[frame];
+    float scale = BOOM_RATIUS * 2.0f / BOOM_FRAME_WIDTH;
+    float x = -BOOM_RATIUS + rect[4] * scale;
+    float y = -BOOM_RATIUS + rect[5] * scale;
+    float u = libCast<float>(rect[0]) / BOOM_SHEET_WIDTH;
+    float v = libCast<float>(rect[1]) / BOOM_SHEET_HEIGHT;
+    float u2 = libCast<float>(rect[0] + rect[2]) / BOOM_SHEET_WIDTH;
+    float v2 = libCast<float>(rect[1] + rect[3]) / BOOM_SHEET_HEIGHT;
+
+    libQuad q_boom(libVertex(x, y, u, v), libVertex(x + rect[2] * scale, y + rect[3] * scale, u2, v2));
+    mesh_boom->Clear();
+    mesh_boom->Add(q_boom, libVec3(boomCoord.x, boomCoord.y, 0.0f));
+}
+
 /*
 ===================
 Game::UpdatePanelsMesh
@@ -481,15 +793,16 @@ void Game::UpdateTilesMesh()
         {
             float x = p2Offset.x + libCast<float>(TILE_SIZE * i) - 1; // Minus 1 for fixing a small gap on the left side
             float y = p2Offset.y + libCast<float>(TILE_SIZE * j);
-            Tile &tile = field[i][j];
+            const Tile &tile = board.At(i, j);
+            libButton &button = buttons[i][j];
 
             // Tiles
-            tile.button.SetSize(TILE_SIZE, TILE_SIZE);
-            tile.button.SetPosition(x + libMath::Ceil(halfTile), y + libMath::Ceil(halfTile));
+            button.SetSize(TILE_SIZE, TILE_SIZE);
+            button.SetPosition(x + libMath::Ceil(halfTile), y + libMath::Ceil(halfTile));
 
-            if (tile.button.texture == tex_tileOpen.Get())
+            if (button.texture == tex_tileOpen.Get())
             {
-                q_tile.SetColor(tile.button.textureColor.base);
+                q_tile.SetColor(button.textureColor.base);
                 mesh_tileOpen->Add(q_tile, libVec3(x, y, 0.0f));
                 q_tile.SetColor(LIB_COLOR_WHITE);
             }
@@ -528,6 +841,46 @@ void Game::UpdateTilesMesh()
     }
 }
 
+/*
+===================
+Game::UpdateHeatmapMesh
+
+Shades closed tiles from green to red by their chance of being a mine, all in one mesh.
+===================
+*/
+void Game::UpdateHeatmapMesh()
+{
+    mesh_heatmap->Clear();
+
+    if (!heatmapShown || gameState != PLAYING || !board.IsGenerated() || libCast<int>(heatmapProbabilities.size()) != board.Size())
+        return;
+
+    libVec2i screenSize(engine->State(LIB_SCREEN_WIDTH), engine->State(LIB_SCREEN_HEIGHT));
+    float inset = TILE_SIZE * HEATMAP_INSET;
+    libQuad q_shade(libVertex(0.0f, 0.0f, 0.0f, 0.0f), libVertex(TILE_SIZE - inset * 2.0f, TILE_SIZE - inset * 2.0f, 1.0f, 1.0f));
+    libVec2i upperPanelSize(screenSize.x - MARGIN_X * 2, TILE_SIZE * 2 + TILE_SIZE);
+    libVec2i p2Offset(MARGIN_X * 2, upperPanelSize.y + MARGIN_Y * 5);
+
+    for (int i = 0; i < fieldSize.x; i++)
+    {
+        for (int j = 0; j < fieldSize.y; j++)
+        {
+            const Tile &tile = board.At(i, j);
+
+            if (tile.state == Tile::OPEN || tile.state == Tile::FLAGGED)
+                continue;
+
+            float x = p2Offset.x + libCast<float>(TILE_SIZE * i) - 1; // Minus 1 for fixing a small gap on the left side
+            float y = p2Offset.y + libCast<float>(TILE_SIZE * j);
+            float probability = heatmapProbabilities[board.Index(i, j)];
+
+            // Yellow halfway
+            q_shade.SetColor(libColor(std::min(1.0f, probability * 2.0f), std::min(1.0f, (1.0f - probability) * 2.0f), 0.0f));
+            mesh_heatmap->Add(q_shade, libVec3(x + inset, y + inset, 0.0f));
+        }
+    }
+}
+
 /*
 ===================
 Game::AddPanelMesh
@@ -571,84 +924,6 @@ void Game::AddPanelMesh(const libVec2 corner, const libVec2 &corner2, float thic
     mesh_panel->Add(q_panel, libVec3(corner.x, corner2.y, 0.0f));
 }
 
-/*
-===================
-Game::GenerateMines
-===================
-*/
-void Game::GenerateMines()
-{
-    libArray<libVec2i> mines;
-    firstClick = false;
-
-    // Gets possible mine locations
-    for (int i = 0; i < fieldSize.x * fieldSize.y; i++)
-    {
-        libVec2i location(i % fieldSize.x, i / fieldSize.x);
-
-        // There should be no mines in adjacent tiles if the number of mines is 9 fewer than the total number of tiles
-        if (fieldSize.x * fieldSize.y - minesLeft >= 9)
-        {
-            bool skip = false;
-
-            for (int j = firstClickCoord.x - 1; j <= firstClickCoord.x + 1; j++)
-                for (int k = firstClickCoord.y - 1; k <= firstClickCoord.y + 1; k++)
-                    if (location == libVec2i(j, k))
-                        skip = true;
-
-            if (skip)
-                continue;
-        }
-        // Otherwise, no mine on the first clicked tile
-        else if (location == firstClickCoord)
-        {
-            continue;
-        }
-
-        mines.Append(location);
-    }
-
-    // Adds mines to the game field
-    for (int i = 0; i < minesLeft; i++)
-    {
-        if (mines.IsEmpty())
-            break;
-
-        int n = libRandom::Int(0, libCast<int>(mines.Size()) - 1);
-        field[mines[n].x][mines[n].y].type = Tile::MINED;
-        mines.RemoveIndex(n);
-    }
-
-    // Calculates the number of nearest mines for each tile
-    for (int i = 0; i < fieldSize.x; i++)
-    {
-        for (int j = 0; j < fieldSize.y; j++)
-        {
-            if (field[i][j].type == Tile::MINED)
-                continue;
-
-            int minesCount = 0;
-
-            for (int x = -1; x <= 1; x++)
-            {
-                for (int y = -1; y <= 1; y++)
-                {
-                    if (i == i + x && j == j + y)
-                        continue;
-
-                    if (i + x < 0 || i + x >= fieldSize.x || j + y < 0 || j + y >= fieldSize.y)
-                        continue;
-
-                    if (field[i + x][j + y].type == Tile::MINED)
-                        minesCount++;
-                }
-            }
-
-            field[i][j].nearestMines = minesCount;
-        }
-    }
-}
-
 /*
 ===================
 Game::UpdateHoveredTile
@@ -660,10 +935,15 @@ void Game::UpdateHoveredTile()
     {
         for (int j = 0; j < fieldSize.y; j++)
         {
-            if (field[i][j].button.IsHovered())
+            if (buttons[i][j].IsHovered())
             {
                 hoveredTile = true;
                 hoveredTileCoord.Set(i, j);
+
+                // A pending click keeps the worker on its own tile
+                if (!board.IsGenerated() && settings.NoGuess() && !openPending)
+                    pool.Hint(i, j);
+
                 return;
             }
         }
@@ -686,8 +966,9 @@ void Game::UpdateTiles()
     {
         for (int j = 0; j < fieldSize.y; j++)
         {
-            Tile &tile = field[i][j];
-            tile.button.Update();
+            const Tile &tile = board.At(i, j);
+            libButton &button = buttons[i][j];
+            button.Update();
 
             // Initiates tile pressing only if it was pressed from the beginning
             if (IsTileHovered(i, j) && (LeftPressed() || MiddlePressed()))
@@ -708,9 +989,9 @@ void Game::UpdateTiles()
                 if (LeftPressing())
                 {
                     // Actually makes the hovered tile pressed
-                    if (tile.CanOpen() && tile.button.texture != tex_tileOpen.Get())
+                    if (tile.CanOpen() && button.texture != tex_tileOpen.Get())
                     {
-                        tile.button.SetTexture(tex_tileOpen.Get());
+                        button.SetTexture(tex_tileOpen.Get());
                         updateTilesMesh = true;
                     }
 
@@ -724,9 +1005,9 @@ void Game::UpdateTiles()
                     SetNeighborPressState(i, j, true);
             }
 
-            if (tile.CanOpen() && IsTileToBeUnpressed(i, j) && tile.button.texture != tex_tile.Get())
+            if (tile.CanOpen() && IsTileToBeUnpressed(i, j) && button.texture != tex_tile.Get())
             {
-                tile.button.SetTexture(tex_tile.Get());
+                button.SetTexture(tex_tile.Get());
                 updateTilesMesh = true;
             }
 
@@ -777,54 +1058,19 @@ void Game::UpdateTileFlags()
     }
 
     // Do not flag a tile if that tile has already been pressed
-    if (LeftPressing() || !RightPressed())
+    if (LeftPressing() || !RightPressed() || !hoveredTile)
         return;
 
-    for (int i = 0; i < fieldSize.x; i++)
-    {
-        for (int j = 0; j < fieldSize.y; j++)
-        {
-            Tile &tile = field[i][j];
-
-            if (tile.state == Tile::OPEN || !IsTileHovered(i, j))
-                continue;
-
-            // Flagged
-            if (tile.state == Tile::CLOSED)
-            {
-                tile.state = Tile::FLAGGED;
-                shownMinesLeft--;
-
-                if (tile.type == Tile::MINED)
-                    minesLeft--;
-
-                updateTilesMesh = true;
-            }
-            // Question mark
-            else if (tile.state == Tile::FLAGGED)
-            {
-                if (settings.MarksEnabled())
-                    tile.state = Tile::QUESTIONED;
-                else
-                    tile.state = Tile::CLOSED;
-
-                shownMinesLeft++;
-                updateTilesMesh = true;
-            }
-            // Closed empty tile
-            else if (tile.state == Tile::QUESTIONED)
-            {
-                tile.state = Tile::CLOSED;
-
-                if (tile.type == Tile::MINED)
-                    minesLeft++;
+    const Tile &tile = board.At(hoveredTileCoord.x, hoveredTileCoord.y);
 
-                updateTilesMesh = true;
-            }
-
-            return;
-        }
+    if (board.State() == Board::PLAYING && tile.state != Tile::OPEN)
+    {
+        rightClicks++;
+        RecordAction(Replay::MarkType(tile.state, settings.MarksEnabled()), hoveredTileCoord.x, hoveredTileCoord.y);
     }
+
+    board.ToggleFlag(hoveredTileCoord.x, hoveredTileCoord.y, settings.MarksEnabled());
+    ApplyBoardChanges();
 }
 
 /*
@@ -924,9 +1170,6 @@ Game::OpenTile
 */
 void Game::OpenTile(int x, int y)
 {
-    firstClickCoord.Set(x, y);
-    Tile &tile = field[x][y];
-
     // Unpress tiles and avoid opening the hovered tile while chording
     if (MiddlePressing() && LeftReleased())
     {
@@ -934,81 +1177,121 @@ void Game::OpenTile(int x, int y)
         return;
     }
 
-    if (!tile.CanOpen())
+    if (!board.At(x, y).CanOpen())
         return;
 
-    if (firstClick)
-        GenerateMines();
-
-    timer.Start();
     tileClicked = false;
-    tile.button.SetTexture(tex_tileOpen.Get());
-    tile.state = Tile::OPEN;
 
-    // Game over - mine explosion 
-    if (tile.type == Tile::MINED)
-    {
-        gameState = LOST;
-        tex_curSmile = tex_smileLost;
-        boomCoord.Set(tile.button.pos.x, tile.button.pos.y);
-        spr_boom->Play();
-        snd_boom->Play();
-        tile.button.textureColor.base = LIB_COLOR_RED;
-        tile.button.SetEnabled(false);
-        timer.Stop();
-        ShowAllMines();
+    if (!GenerateBoard(x, y))
+        return;
 
-        // Adjusts the difficulty level
-        if (settings.Difficulty() == Settings::AUTO)
-        {
-            attempts++;
+    timer.Start();
+    leftClicks++;
+    RecordAction(Replay::OPEN, x, y);
+    board.Open(x, y);
+    ApplyBoardChanges();
+}
 
-            if (attempts >= ATTEMPTS_BEFORE_CHANGE)
-            {
-                attempts = 0;
-                mineRatio -= MINE_RATIO_CHANGE;
+/*
+===================
+Game::GenerateBoard
 
-                if (mineRatio < MINIMAL_MINE_RATIO)
-                    mineRatio = MINIMAL_MINE_RATIO;
-            }
-        }
+Ordinary boards come from the seed of the game and the first click, so they can be made again.
+No-guess boards come from the pool. If it has none for the tile yet, the click is kept pending
+and false is returned. On fields where the pool keeps failing, an ordinary board is made instead.
+===================
+*/
+bool Game::GenerateBoard(int x, int y)
+{
+    if (board.IsGenerated())
+        return true;
 
-        updateTilesMesh = true;
-        return;
+    if (!settings.NoGuess())
+        Generator::FromSeed(board, gameSeed, x, y);
+    else if (pool.Take(board, x, y))
+        gameSeed = 0;   // Found by a search that the seed can't repeat
+    else if (!pool.IsFailing())
+    {
+        // The worker searches for this tile next, it isn't running yet if no-guess was turned on during the game
+        if (!openPending)
+            pool.Start(board);
+
+        pool.Hint(x, y);
+        pendingOpen.Set(x, y);
+        openPending = true;
+        tex_curSmile = tex_smileClick;
+        return false;
     }
+    else
+        Generator::FromSeed(board, gameSeed, x, y);
 
-    if (tile.HasNoNearestMines())
-        OpenEmptyNeighborTiles();
+    firstClick.Set(x, y);
+    metrics.Compute(board);
+    recorder.SetBoard(board, gameSeed);
+    return true;
+}
 
-    if (!hasUnopenEmptyTiles())
-    {
-        gameState = WON;
-        tex_curSmile = tex_smileWin;
-        timer.Stop();
-        FlagClosedMineTiles();
+/*
+===================
+Game::ApplyBotCommand
 
-        // Adjusts the difficulty level
-        if (settings.Difficulty() == Settings::AUTO)
-        {
-            attempts = 0;
-            mineRatio += MINE_RATIO_CHANGE;
+Moves of external bots follow the same rules as clicks, without any of the mouse handling.
+The caller applies the board changes once the whole batch of commands is done.
+===================
+*/
+void Game::ApplyBotCommand(const mf_command_t &command)
+{
+    if (command.action == MF_RESTART)
+    {
+        // The game the batch has finished so far has to end before it's abandoned
+        ApplyBoardChanges();
+        Restart();
+        return;
+    }
 
-            if (gameTime < PREFERRED_GAME_DURATION)
-            {
-                autoFieldSize.x++;
-                autoFieldSize.y++;
-            }
-            else
-            {
-                autoFieldSize.x--;
-                autoFieldSize.y--;
-            }
-        }
+    int x = command.x;
+    int y = command.y;
 
-        ClampFieldDimensions();
+    if (board.State() != Board::PLAYING || !board.IsInside(x, y))
+        return;
+
+    // Games bots take part in aren't recorded unless BotLinkRecord is set
+    if (!botGame)
+    {
+        botGame = true;
+
+        if (!recordBots)
+            recorder.Cancel();
     }
 
-    updateTilesMesh = true;
+    const Tile &tile = board.At(x, y);
+
+    if (command.action == MF_OPEN && tile.CanOpen())
+    {
+        if (!GenerateBoard(x, y))
+            return;
+
+        timer.Start();
+        leftClicks++;
+        RecordAction(Replay::OPEN, x, y);
+        board.Open(x, y);
+    }
+    else if (command.action == MF_CHORD && tile.state == Tile::OPEN && tile.nearestMines)
+    {
+        chordClicks++;
+        RecordAction(Replay::CHORD, x, y);
+        board.Chord(x, y);
+    }
+    else if (command.action == MF_FLAG && tile.state != Tile::OPEN)
+    {
+        rightClicks++;
+        RecordAction(Replay::MarkType(tile.state, false), x, y);
+        board.ToggleFlag(x, y, false);
+    }
+
+    // Every move is its own step to undo in practice
+    if (practice)
+        ApplyBoardChanges();
 }
 
 /*
@@ -1020,50 +1303,102 @@ This allows to quickly reveal adjacent tiles if the number of mines matches the
 */
 void Game::Chord(int x, int y)
 {
-    if (field[x][y].state != Tile::OPEN)
-        return;
+    const Tile &tile = board.At(x, y);
 
     // A chord is allowed only if we have at least one mine
-    if (!field[x][y].nearestMines)
+    if (tile.state != Tile::OPEN || !tile.nearestMines)
         return;
 
     tileClicked = false;
-    int flags = 0;
 
-    // Counts the number of flags
-    for (int i = x - 1; i <= x + 1; i++)
-    {
-        for (int j = y - 1; j <= y + 1; j++)
-        {
-            if (i < 0 || j < 0)
-                continue;
+    // Unpress tiles and avoid opening adjacent tiles while chording with the wheel button
+    if (MiddlePressing() && LeftReleased())
+        return;
 
-            if (i >= fieldSize.x || j >= fieldSize.y)
-                continue;
+    chordClicks++;
+    RecordAction(Replay::CHORD, x, y);
+    board.Chord(x, y);
+    ApplyBoardChanges();
+}
 
-            if (i == x && j == y)
-                continue;
+/*
+===================
+Game::ApplyBoardChanges
 
-            if (field[i][j].state == Tile::FLAGGED)
-                flags++;
-        }
+Catches the buttons up with the tiles the board has changed and handles the end of the game.
+===================
+*/
+void Game::ApplyBoardChanges()
+{
+    const std::vector<int> &changes = board.Changes();
+    bool changed = boardChanges < changes.size();
+    bool opened = false;
+
+    for (; boardChanges < changes.size(); boardChanges++)
+    {
+        int index = changes[boardChanges];
+        bool open = board[index].state == Tile::OPEN;
+
+        // Undone moves close tiles again
+        buttons[board.X(index)][board.Y(index)].SetTexture(open ? tex_tileOpen.Get() : tex_tile.Get());
+        opened |= open;
     }
 
-    if (flags != field[x][y].nearestMines)
+    updateTilesMesh |= changed;
+
+    // The move that ends the game is kept as well, so it can be undone
+    if (practice && !watching && board.IsGenerated())
+        moves.Commit(board);
+
+    // Only opened tiles tell anything new, flags are the player's guesses
+    if (heatmapShown && opened && board.State() == Board::PLAYING)
+        heatmap.Request(board);
+
+    // Practice games have no replay to resume with, so they aren't kept
+    if (changed && !watching && !practice && board.IsGenerated() && board.State() == Board::PLAYING && ++movesSinceSave >= AUTOSAVE_MOVES)
+        AutosaveGame();
+
+    if (gameState != PLAYING || board.State() == Board::PLAYING)
         return;
 
-    // Opens adjacent tiles
-    for (int i = x - 1; i <= x + 1; i++)
+    timer.Stop();
+    autosave.Remove();
+
+    // Game over - mine explosion
+    if (board.State() == Board::LOST)
     {
-        for (int j = y - 1; j <= y + 1; j++)
+        gameState = LOST;
+        tex_curSmile = tex_smileLost;
+
+        libButton &button = buttons[board.X(board.Exploded())][board.Y(board.Exploded())];
+        boomCoord.Set(button.pos.x, button.pos.y);
+
+        if (LoadDeferred())
         {
-            if (i < 0 || j < 0)
-                continue;
+            boomTimer.Reset();
+            boomTimer.Start();
+            snd_boom->Play();
+        }
 
-            if (i >= fieldSize.x || j >= fieldSize.y)
-                continue;
+        button.textureColor.base = LIB_COLOR_RED;
+        button.SetEnabled(false);
+        ShowAllMines();
 
-            OpenTile(i, j);
+        if (!watching && !practice && (!botGame || recordBots))
+        {
+            RecordGame(false);
+            AdjustDifficulty(false);
+        }
+    }
+    else
+    {
+        gameState = WON;
+        tex_curSmile = tex_smileWin;
+
+        if (!watching && !practice && (!botGame || recordBots))
+        {
+            RecordGame(true);
+            AdjustDifficulty(true);
         }
     }
 }
@@ -1087,15 +1422,13 @@ void Game::SetNeighborPressState(int x, int y, bool pressed)
             if (i >= fieldSize.x || j >= fieldSize.y)
                 continue;
 
-            Tile &tile = field[i][j];
-
-            if (!tile.CanOpen())
+            if (!board.At(i, j).CanOpen())
                 continue;
 
             if (pressed)
-                tile.button.SetTexture(tex_tileOpen.Get());
+                buttons[i][j].SetTexture(tex_tileOpen.Get());
             else
-                tile.button.SetTexture(tex_tile.Get());
+                buttons[i][j].SetTexture(tex_tile.Get());
         }
     }
 
@@ -1104,73 +1437,165 @@ void Game::SetNeighborPressState(int x, int y, bool pressed)
 
 /*
 ===================
-Game::OpenEmptyNeighborTiles
+Game::ShowAllMines
 ===================
 */
-void Game::OpenEmptyNeighborTiles()
+void Game::ShowAllMines()
 {
-    for (bool done = false; !done;)
+    for (int i = 0; i < fieldSize.x; i++)
     {
-        done = true;
-
-        for (int i = 0; i < fieldSize.x; i++)
+        for (int j = 0; j < fieldSize.y; j++)
         {
-            for (int j = 0; j < fieldSize.y; j++)
-            {
-                Tile &tile = field[i][j];
+            if (board.At(i, j).IsIncorrectlyFlaggedOrMined())
+                buttons[i][j].SetTexture(tex_tileOpen.Get());
+        }
+    }
 
-                if (tile.type == Tile::MINED || tile.state == Tile::OPEN)
-                    continue;
+    updateTilesMesh = true;
+}
 
-                for (int x = -1; x <= 1; x++)
-                {
-                    for (int y = -1; y <= 1; y++)
-                    {
-                        if (i == i + x && j == j + y)
-                            continue;
+/*
+===================
+Game::ShowBoardCode
+===================
+*/
+void Game::ShowBoardCode() const
+{
+    BoardCode::code_t code;
+    code.width = fieldSize.x;
+    code.height = fieldSize.y;
+    code.mines = board.Mines();
+    code.x = firstClick.x;
+    code.y = firstClick.y;
+    code.seed = gameSeed;
+
+    std::string text = board.IsGenerated() && gameSeed ? BoardCode::Encode(code) : std::string();
+
+    if (!text.empty())
+        libDialog::Information(libFormat("Board Code"), text.c_str());
+    else if (!board.IsGenerated())
+        libDialog::Information(libFormat("Board Code"), "The board gets its code with the first click.");
+    else
+        libDialog::Information(libFormat("Board Code"), "No-guess boards are searched for and have no code.");
+}
 
-                        if (i + x < 0 || i + x >= fieldSize.x)
-                            continue;
+/*
+===================
+Game::ToggleCodeEntry
+===================
+*/
+void Game::ToggleCodeEntry()
+{
+    enteringCode = !enteringCode;
+    typedCode.clear();
+}
 
-                        if (j + y < 0 || j + y >= fieldSize.y)
-                            continue;
+/*
+===================
+Game::TypeBoardCode
 
-                        if (field[i + x][j + y].state != Tile::OPEN || field[i + x][j + y].nearestMines)
-                            continue;
+The board is played as soon as the last symbol of a valid code is typed.
+===================
+*/
+void Game::TypeBoardCode()
+{
+    int key = engine->CurrentKey();
 
-                        if (tile.state == Tile::FLAGGED)
-                            shownMinesLeft++;
+    if (!key)
+        return;
 
-                        tile.button.SetTexture(tex_tileOpen.Get());
-                        tile.state = Tile::OPEN;
-                        done = false;
-                    }
-                }
-            }
-        }
+    if (engine->IsKeyPressed(LIBK_BACKSPACE))
+    {
+        if (!typedCode.empty())
+            typedCode.pop_back();
+
+        return;
     }
 
-    updateTilesMesh = true;
+    char symbol = engine->KeyValue(key);
+
+    if (!BoardCode::IsSymbol(symbol) || typedCode.size() >= BOARD_CODE_SYMBOLS)
+        return;
+
+    if (symbol >= 'a' && symbol <= 'z')
+        symbol = libCast<char>(symbol - 'a' + 'A');
+
+    typedCode += symbol;
+
+    if (typedCode.size() == BOARD_CODE_SYMBOLS && BoardCode::Decode(typedCode.c_str(), pendingCode))
+    {
+        codePending = true;
+        enteringCode = false;
+        typedCode.clear();
+        Restart();
+    }
 }
 
 /*
 ===================
-Game::FlagClosedMineTiles
+Game::RecordGame
 ===================
 */
-void Game::FlagClosedMineTiles()
+void Game::RecordGame(bool won)
+{
+    History::game_t game;
+    game.seed = gameSeed;
+    game.firstClick = libCast<uint16_t>(board.Index(firstClick.x, firstClick.y));
+    game.date = libCast<int64_t>(std::time(nullptr));
+    game.milliseconds = libCast<uint32_t>(PlayedSeconds() * 1000.0);
+    game.width = libCast<uint16_t>(fieldSize.x);
+    game.height = libCast<uint16_t>(fieldSize.y);
+    game.mines = libCast<uint16_t>(board.Mines());
+    game.threeBV = libCast<uint16_t>(metrics.ThreeBV());
+    game.leftClicks = libCast<uint16_t>(leftClicks);
+    game.rightClicks = libCast<uint16_t>(rightClicks);
+    game.chordClicks = libCast<uint16_t>(chordClicks);
+    game.difficulty = libCast<uint8_t>(FieldDifficulty());
+    game.won = won;
+
+    history.Append(game);
+    recorder.Finish(won ? Replay::WON : Replay::LOST);
+}
+
+/*
+===================
+Game::AbandonGame
+
+A game that is given up is recorded too, the restart is its last action.
+===================
+*/
+void Game::AbandonGame()
+{
+    if (gameState != PLAYING)
+        return;
+
+    // The snapshot goes with the game
+    if (board.IsGenerated())
+        autosave.Remove();
+
+    if (!recorder.IsRecording())
+        return;
+
+    RecordAction(Replay::RESTART, 0, 0);
+    recorder.Finish(Replay::ABANDONED);
+}
+
+/*
+===================
+Game::ResetButtons
+===================
+*/
+void Game::ResetButtons()
 {
     for (int i = 0; i < fieldSize.x; i++)
     {
         for (int j = 0; j < fieldSize.y; j++)
         {
-            Tile &tile = field[i][j];
-
-            if (tile.type != Tile::MINED || tile.state == Tile::OPEN || tile.state == Tile::FLAGGED)
-                continue;
+            libButton &button = buttons[i][j];
 
-            tile.state = Tile::FLAGGED;
-            shownMinesLeft--;
+            button.SetTexture(tex_tile.Get());
+            button.SetEnabled(true);
+            button.textureColor.base = LIB_COLOR_WHITE;
         }
     }
 
@@ -1179,25 +1604,368 @@ void Game::FlagClosedMineTiles()
 
 /*
 ===================
-Game::ShowAllMines
+Game::WatchReplay
+
+Shows the last finished game again, or goes back to playing.
 ===================
 */
-void Game::ShowAllMines()
+void Game::WatchReplay()
 {
-    for (int i = 0; i < fieldSize.x; i++)
+    if (watching)
     {
-        for (int j = 0; j < fieldSize.y; j++)
-        {
-            Tile &tile = field[i][j];
+        Restart();
+        return;
+    }
 
-            if (tile.IsIncorrectlyFlaggedOrMined())
-                tile.button.SetTexture(tex_tileOpen.Get());
-        }
+    if (!recorder.Last().header.actions)
+    {
+        libDialog::Information(libFormat("Replay"), "No game has been finished yet.");
+        return;
     }
 
+    // Copied first, giving up the game being played makes it the last one
+    watched = recorder.Last();
+    AbandonGame();
+
+    // The writer thread builds them for the saved file only
+    if (watched.Keyframes().empty())
+        watched.BuildKeyframes();
+
+    fieldSize.Set(libCast<int>(watched.header.width), libCast<int>(watched.header.height));
+    player.Start(watched, board);
+    boardChanges = 0;
+    heatmapProbabilities.clear();
+    ResetButtons();
+
+    gameTime = 0;
+    leftClicks = rightClicks = chordClicks = 0;
+    gameState = PLAYING;
+    tex_curSmile = tex_smile;
+    timer.Reset();
+    boomTimer.Reset();
+
+    watching = true;
+    replaySpeed = 1;
+    replayClock = 0.0;
+    replayFrame = std::chrono::steady_clock::now();
+
+    AdjustWindowSize();
+    UpdatePanelsMesh();
     updateTilesMesh = true;
 }
 
+/*
+===================
+Game::UpdateReplay
+
+Applies every action whose time has come, at the chosen speed.
+===================
+*/
+void Game::UpdateReplay()
+{
+    int key = engine->CurrentKey();
+    char symbol = key ? engine->KeyValue(key) : 0;
+
+    if (symbol >= '1' && symbol <= '5')
+        replaySpeed = 1 << (symbol - '1');
+    else if (symbol == '0')
+        replaySpeed = 0;
+    else if (symbol == ',' || symbol == '.')
+        SeekReplay(replayClock + (symbol == '.' ? REPLAY_SEEK_MILLISECONDS : -REPLAY_SEEK_MILLISECONDS));
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    replayClock += std::chrono::duration<double, std::milli>(now - replayFrame).count() * replaySpeed;
+    replayFrame = now;
+
+    bool generated = board.IsGenerated();
+    bool stepped = false;
+
+    while (!player.IsDone() && player.NextMilliseconds() <= replayClock)
+        stepped |= player.Step(board);
+
+    if (player.IsDone())
+        replayClock = player.Action().milliseconds;
+
+    if (!stepped)
+        return;
+
+    if (!generated && board.IsGenerated())
+        metrics.Compute(board);
+
+    leftClicks = player.leftClicks;
+    rightClicks = player.rightClicks;
+    chordClicks = player.chordClicks;
+
+    // The buttons were all closed above, the journal of the board lists every tile that isn't closed any more
+    ApplyBoardChanges();
+}
+
+/*
+===================
+Game::SeekReplay
+
+The board may go back as well as forward, so every tile is shown again.
+===================
+*/
+void Game::SeekReplay(double milliseconds)
+{
+    replayClock = std::clamp(milliseconds, 0.0, libCast<double>(watched.header.milliseconds));
+    player.Seek(board, libCast<uint32_t>(replayClock));
+
+    if (board.IsGenerated())
+        metrics.Compute(board);
+
+    ResetButtons();
+    boardChanges = 0;
+    gameState = PLAYING;
+    tex_curSmile = tex_smile;
+    boomTimer.Reset();
+
+    leftClicks = player.leftClicks;
+    rightClicks = player.rightClicks;
+    chordClicks = player.chordClicks;
+    ApplyBoardChanges();
+}
+
+/*
+===================
+Game::UpdatePractice
+
+Z undoes a move, even the one that lost the game, and Y redoes it.
+===================
+*/
+void Game::UpdatePractice()
+{
+    int key = engine->CurrentKey();
+    char symbol = key ? engine->KeyValue(key) : 0;
+
+    if (symbol == 'z' || symbol == 'Z')
+    {
+        if (!moves.Undo(board))
+            return;
+    }
+    else if (symbol == 'y' || symbol == 'Y')
+    {
+        if (!moves.Redo(board))
+            return;
+    }
+    else
+    {
+        return;
+    }
+
+    // A finished game goes on, the buttons lose what the end of the game has shown on them
+    if (gameState != PLAYING)
+    {
+        gameState = PLAYING;
+        tex_curSmile = tex_smile;
+        boomTimer.Reset();
+        timer.Start();
+        ResetButtons();
+        boardChanges = 0;
+    }
+
+    // Closed tiles tell less than before, so the heatmap is made again
+    if (heatmapShown && board.State() == Board::PLAYING)
+        heatmap.Request(board);
+
+    ApplyBoardChanges();
+}
+
+/*
+===================
+Game::PlayedSeconds
+
+On the game's clock, or on the replay's while watching one.
+===================
+*/
+double Game::PlayedSeconds() const
+{
+    return watching ? replayClock / 1000.0 : resumedSeconds + timer.Seconds();
+}
+
+/*
+===================
+Game::SaveGame
+
+Keeps the game being played for the next start, called on exit.
+===================
+*/
+void Game::SaveGame()
+{
+    if (!watching && !practice && gameState == PLAYING && board.IsGenerated())
+        AutosaveGame();
+
+    autosave.Stop();
+}
+
+/*
+===================
+Game::AutosaveGame
+
+Only fills the spare snapshot, the disk is left to the writer thread.
+===================
+*/
+void Game::AutosaveGame()
+{
+    snapshot.Capture(board);
+    snapshot.seed = gameSeed;
+    snapshot.firstClickX = firstClick.x;
+    snapshot.firstClickY = firstClick.y;
+    snapshot.milliseconds = libCast<uint32_t>(PlayedSeconds() * 1000.0);
+    snapshot.leftClicks = leftClicks;
+    snapshot.rightClicks = rightClicks;
+    snapshot.chordClicks = chordClicks;
+    snapshot.difficulty = settings.Difficulty();
+    snapshot.autoWidth = autoFieldSize.x;
+    snapshot.autoHeight = autoFieldSize.y;
+    snapshot.mineRatio = mineRatio;
+    snapshot.belief = autoDifficulty.belief;
+    snapshot.replay = recorder.Current();
+
+    autosave.Save(snapshot);
+    movesSinceSave = 0;
+}
+
+/*
+===================
+Game::ResumeGame
+
+Goes on with the game that was being played when the program was closed. Practice games aren't saved.
+===================
+*/
+void Game::ResumeGame(const char *path)
+{
+    if (practice || !snapshot.Load(path))
+        return;
+
+    // Made by another build, or with another difficulty than the one chosen now
+    if (libCast<int>(snapshot.width) > MAXIMAL_FIELD_WIDTH || libCast<int>(snapshot.height) > MAXIMAL_FIELD_HEIGHT ||
+        snapshot.difficulty != settings.Difficulty())
+        return;
+
+    fieldSize.Set(libCast<int>(snapshot.width), libCast<int>(snapshot.height));
+    snapshot.Restore(board);
+    boardChanges = 0;
+    metrics.Compute(board);
+    ResetButtons();
+
+    gameSeed = snapshot.seed;
+    firstClick.Set(snapshot.firstClickX, snapshot.firstClickY);
+    leftClicks = snapshot.leftClicks;
+    rightClicks = snapshot.rightClicks;
+    chordClicks = snapshot.chordClicks;
+    autoFieldSize.Set(snapshot.autoWidth, snapshot.autoHeight);
+    mineRatio = snapshot.mineRatio;
+    autoDifficulty.belief = snapshot.belief;
+
+    recorder.Resume(snapshot.replay);
+
+    resumedSeconds = snapshot.milliseconds / 1000.0;
+    timer.Reset();
+    timer.Start();
+
+    if (heatmapShown)
+        heatmap.Request(board);
+
+    ApplyBoardChanges();
+    AdjustWindowSize();
+    UpdatePanelsMesh();
+    updateTilesMesh = true;
+}
+
+/*
+===================
+Game::RecordAction
+
+Stamped with the game's clock, which only starts with the first opened tile.
+===================
+*/
+void Game::RecordAction(Replay::type_t type, int x, int y)
+{
+    recorder.Record(type, x, y, libCast<uint32_t>(PlayedSeconds() * 1000.0));
+}
+
+/*
+===================
+Game::AdjustDifficulty
+
+Learns from the finished game and picks the next field of the Auto difficulty.
+===================
+*/
+void Game::AdjustDifficulty(bool won)
+{
+    if (FieldDifficulty() != Settings::AUTO)
+        return;
+
+    AutoDifficulty::game_t game;
+    game.width = fieldSize.x;
+    game.height = fieldSize.y;
+    game.mines = board.Mines();
+    game.won = won;
+    game.seconds = libCast<float>(PlayedSeconds());
+    game.openedTiles = board.Size() - board.Mines() - board.ClosedSafeTiles();
+
+    autoDifficulty.Record(game);
+    autoDifficulty.Next(autoFieldSize.x, autoFieldSize.y, mineRatio);
+    ClampFieldDimensions();
+}
+
+/*
+===================
+Game::DifficultyField
+
+The field of the chosen difficulty.
+===================
+*/
+void Game::DifficultyField(libVec2i &size, int &mines) const
+{
+    if (settings.Difficulty() == Settings::BEGINNER)
+    {
+        size.Set(10, 10);
+        mines = 10;
+    }
+    else if (settings.Difficulty() == Settings::INTERMEDIATE)
+    {
+        size.Set(16, 16);
+        mines = 40;
+    }
+    else if (settings.Difficulty() == Settings::EXPERT)
+    {
+        size.Set(30, 16);
+        mines = 99;
+    }
+    else if (settings.Difficulty() == Settings::AUTO)
+    {
+        size = autoFieldSize;
+        mines = libCast<int>(size.x * size.y * mineRatio);
+    }
+    else if (settings.Difficulty() == Settings::CUSTOM)
+    {
+        size.Set(settings.CustomWidth(), settings.CustomHeight());
+        mines = settings.CustomMines();
+    }
+}
+
+/*
+===================
+Game::FieldDifficulty
+
+A board code or seed can give another field than the chosen difficulty has, such a game counts as Custom.
+===================
+*/
+Settings::difficulty_t Game::FieldDifficulty() const
+{
+    libVec2i size;
+    int mines = 0;
+    DifficultyField(size, mines);
+
+    if (size.x != fieldSize.x || size.y != fieldSize.y || mines != board.Mines())
+        return Settings::CUSTOM;
+
+    return settings.Difficulty();
+}
+
 /*
 ===================
 Game::ClampFieldDimensions
@@ -1234,7 +2002,7 @@ void Game::AdjustWindowSize()
         int height = libCast<int>(10 * TILE_SIZE + buttonRestart.size.y + TILE_SIZE);
 
         width += MARGIN_X * 4;
-        height += MARGIN_Y * 7;
+        height += MARGIN_Y * 7 + TOGGLE_ROWS_HEIGHT;
 
         engine->SetState(LIB_WINDOW_SIZE, width, height);
     }
@@ -1250,21 +2018,6 @@ void Game::AdjustWindowSize()
     }
 }
 
-/*
-===================
-Game::hasUnopenEmptyTiles
-===================
-*/
-bool Game::hasUnopenEmptyTiles() const
-{
-    for (int i = 0; i < fieldSize.x; i++)
-        for (int j = 0; j < fieldSize.y; j++)
-            if (field[i][j].type == Tile::EMPTY && field[i][j].state != Tile::OPEN)
-                return true;
-
-    return false;
-}
-
 /*
 ===================
 Game::IsTileToBeUnpressed
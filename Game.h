@@ -20,8 +20,20 @@
 #pragma once
 
 #include "Main.h"
-#include "Tile.h"
+#include "Board.h"
+#include "Generator.h"
+#include "BoardPool.h"
+#include "Metrics.h"
+#include "Heatmap.h"
+#include "BotHost.h"
+#include "AutoDifficulty.h"
+#include "History.h"
+#include "Replay.h"
+#include "Snapshot.h"
+#include "MoveHistory.h"
+#include "BoardCode.h"
 #include "Settings.h"
+#include "Assets.h"
 
 #define MARGIN_X                    5
 #define MARGIN_Y                    5
@@ -31,22 +43,11 @@
 #define BOOM_DURATION               1920.0f
 #define SCOREBOARD_MIN_VALUE        -99
 #define SCOREBOARD_MAX_VALUE        999
-#define MINIMAL_FIELD_WIDTH         10
-#define MINIMAL_FIELD_HEIGHT        10
-#define MAXIMAL_FIELD_WIDTH         70
-#define MAXIMAL_FIELD_HEIGHT        35
 #define MINIMAL_MINES               10
 #define MAXIMAL_MINES               MAXIMAL_FIELD_WIDTH * MAXIMAL_FIELD_HEIGHT
-
-// Auto difficulty constants
-#define PREFERRED_GAME_DURATION     300
-#define DEFAULT_MINE_RATIO          0.15f
-#define DEFAULT_AUTO_FIELD_WIDTH    25
-#define DEFAULT_AUTO_FIELD_HEIGHT   22
-#define ATTEMPTS_BEFORE_CHANGE      3
-#define MINE_RATIO_CHANGE           0.005f
-#define MINIMAL_MINE_RATIO          0.05f
-#define MAXIMAL_MINE_RATIO          0.25f
+#define HEATMAP_INSET               0.3f    // Part of the tile left unshaded on every side
+#define REPLAY_SEEK_MILLISECONDS    5000.0  // How far comma and period move in a replay
+#define AUTOSAVE_MOVES              10      // Moves between snapshots of the game being played
 
 class Settings;
 
@@ -76,20 +77,28 @@ public:
 
     void                Restart();
     void                SaveSettings();
+    void                SaveGame();
 
     void                ShowHelp() const;
     void                ToggleSettings();
     void                ToggleAudio();
+    void                ToggleHeatmap();
+    void                TogglePractice();
 
     libCfg              cfg;
+    Assets              assets;
 
 private:
 
+    bool                LoadDeferred();
+
+    bool                IsBoomPlaying() const;
+    void                UpdateBoomMesh();
     void                UpdatePanelsMesh();
     void                UpdateTilesMesh();
+    void                UpdateHeatmapMesh();
     void                AddPanelMesh(const libVec2 corner, const libVec2 &corner2, float thickness);
 
-    void                GenerateMines();
     void                UpdateHoveredTile();
     void                UpdateTiles();
     void                UpdateTileFlags();
@@ -105,38 +114,93 @@ private:
     bool                MiddlePressing() const;
     
     void                OpenTile(int x, int y);
+    bool                GenerateBoard(int x, int y);
+    void                ApplyBotCommand(const mf_command_t &command);
     void                Chord(int x, int y);
+    void                ApplyBoardChanges();
     void                SetNeighborPressState(int x, int y, bool pressed);
-    void                OpenEmptyNeighborTiles();
-    void                FlagClosedMineTiles();
     void                ShowAllMines();
+    void                ShowBoardCode() const;
+    void                ToggleCodeEntry();
+    void                TypeBoardCode();
+    void                RecordGame(bool won);
+    void                RecordAction(Replay::type_t type, int x, int y);
+    void                AbandonGame();
+    void                ResetButtons();
+    void                WatchReplay();
+    void                UpdateReplay();
+    void                SeekReplay(double milliseconds);
+    void                UpdatePractice();
+    double              PlayedSeconds() const;
+    void                AutosaveGame();
+    void                ResumeGame(const char *path);
+    void                AdjustDifficulty(bool won);
+    void                DifficultyField(libVec2i &size, int &mines) const;
+    Settings::difficulty_t FieldDifficulty() const;
     void                ClampFieldDimensions();
     void                AdjustWindowSize();
 
-    bool                hasUnopenEmptyTiles() const;
     bool                IsTileToBeUnpressed(int x, int y) const;
     bool                IsAdjacentTileHovered(int x, int y) const;
     bool                IsTileHovered(int x, int y) const;
 
     Settings            settings;
 
-    Tile                field[MAXIMAL_FIELD_WIDTH][MAXIMAL_FIELD_HEIGHT];
+    Board               board;
+    BoardPool           pool;
+    Metrics             metrics;
+    Heatmap             heatmap;
+    std::vector<float>  heatmapProbabilities;   // Last complete result, empty until the first one arrives
+    bool                heatmapShown = false;
+    BotHost             botHost;            // Lets bots in other processes play if enabled in the config
+    bool                recordBots = false; // Keeps games bots play as replays and in the history
+    bool                botGame = false;    // A bot has made a move in this game
+    uint64_t            boardSeed = 0;      // Plays this seed next if not 0
+    uint64_t            gameSeed = 0;       // Seed of the board being played, 0 if it has none
+    libVec2i            firstClick;         // The seed makes the board from this tile
+    libVec2i            pendingOpen;        // Opened once the pool has its no-guess board if openPending
+    bool                openPending = false;
+    Random              seeds;
+    BoardCode::code_t   pendingCode;        // Played on the next restart if codePending
+    bool                codePending = false;
+    bool                enteringCode = false;
+    std::string         typedCode;          // Symbols typed so far, without dashes
+    History             history;            // Every finished game
+    ReplayRecorder      recorder;           // Every action of the game being played
+    Replay              watched;
+    ReplayPlayer        player;
+    bool                watching = false;   // The board shows a replay instead of a game
+    int                 replaySpeed = 1;    // Paused if 0
+    double              replayClock = 0.0;  // Milliseconds into the replay
+    std::chrono::steady_clock::time_point replayFrame;
+    Snapshot            snapshot;           // Spare buffer, swapped with the one the writer has
+    Autosave            autosave;
+    int                 movesSinceSave = 0;
+    double              resumedSeconds = 0.0;   // Played before the game was resumed
+    MoveHistory         moves;              // Every position of a practice game
+    bool                practice = false;   // Moves can be undone, games aren't counted
+    int                 leftClicks = 0;
+    int                 rightClicks = 0;
+    int                 chordClicks = 0;
+    size_t              boardChanges = 0;
+    libButton           buttons[MAXIMAL_FIELD_WIDTH][MAXIMAL_FIELD_HEIGHT];
     bool                tileClicked = false;
     bool                hoveredTile = false;
     libVec2i            hoveredTileCoord;
-    bool                firstClick = false;
-    libVec2i            firstClickCoord;
 
     libVec2i            fieldSize;
     libVec2i            autoFieldSize;
     float               mineRatio = DEFAULT_MINE_RATIO;
-    int                 shownMinesLeft = 0;
-    int                 minesLeft = 0;
     int                 gameTime = 0;
-    int                 attempts = 0;
+    AutoDifficulty      autoDifficulty;
     libTimer            timer;
     bool                settingsShown = false;
     bool                updateTilesMesh = false;
+    bool                updateHeatmapMesh = false;
+    bool                deferredTried = false;
+    bool                deferredLoaded = false;
+    int                 framesDrawn = 0;
+    std::chrono::steady_clock::time_point startupStart;
 
     libPtr<libMesh>     mesh_smile;
     libPtr<libMesh>     mesh_scoreboard;
@@ -147,6 +211,8 @@ private:
     libPtr<libMesh>     mesh_flag;
     libPtr<libMesh>     mesh_panel;
     libPtr<libMesh>     mesh_lines;
+    libPtr<libMesh>     mesh_boom;
+    libPtr<libMesh>     mesh_heatmap;
 
     libPtr<libFont>     font;
     libPtr<libFont>     digital;
@@ -162,10 +228,11 @@ private:
     libPtr<libTexture>  tex_mine;
     libPtr<libTexture>  tex_flag;
     libPtr<libTexture>  tex_question;
-    libPtr<libSprite>   spr_boom;
+    libPtr<libTexture>  tex_boom;
     libPtr<libSound>    snd_boom;
 
     libVec2             boomCoord;
+    libTimer            boomTimer;
     libButton           buttonRestart;
     libButton           buttonSettings;
 };
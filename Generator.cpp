@@ -0,0 +1,139 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Generator.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+===================
+Generator::Generate
+===================
+*/
+bool Generator::Generate(Board &board, int x, int y)
+{
+    auto started = std::chrono::steady_clock::now();
+    auto deadline = started + std::chrono::milliseconds(timeBudget);
+    int threadCount = threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    uint64_t run = runs++;
+
+    std::atomic<bool> found = false;
+    std::atomic<int> attempts = 0;
+    std::mutex mutex;
+    std::vector<int> mined;
+
+    auto worker = [&](int index)
+    {
+        Random random(seed, run);
+
+        for (int i = 0; i < index; i++)
+            random.Jump();
+
+        Board candidate;
+        Solver solver;
+
+        while (!found && std::chrono::steady_clock::now() < deadline)
+        {
+            candidate = board;
+            candidate.GenerateMines(x, y, random);
+            attempts++;
+
+            // Mines have to be taken before solving, it flags them all once the board is won
+            std::vector<int> layout;
+
+            for (int i = 0; i < candidate.Size(); i++)
+                if (candidate[i].type == Tile::MINED)
+                    layout.push_back(i);
+
+            if (!IsSolvable(candidate, solver, x, y))
+                continue;
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (!found)
+            {
+                mined = std::move(layout);
+                found = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    for (int i = 1; i < threadCount; i++)
+        pool.emplace_back(worker, i);
+
+    worker(0);
+
+    for (std::thread &thread : pool)
+        thread.join();
+
+    if (found)
+        board.PlaceMines(mined);
+
+    stats.attempts = attempts;
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    stats.noGuess = found;
+
+    return found;
+}
+
+/*
+===================
+Generator::IsSolvable
+===================
+*/
+bool Generator::IsSolvable(Board &board, Solver &solver, int x, int y)
+{
+    board.Open(x, y);
+    solver.Reset(board);
+
+    std::vector<int> safe;
+
+    while (board.State() == Board::PLAYING && !solver.SafeTiles().empty())
+    {
+        safe = solver.SafeTiles();
+
+        for (int index : safe)
+            board.Open(board.X(index), board.Y(index));
+
+        solver.Update(board);
+    }
+
+    return board.State() == Board::WON;
+}
+
+/*
+===================
+Generator::FromSeed
+
+The board has to be reset but not generated yet.
+===================
+*/
+void Generator::FromSeed(Board &board, uint64_t seed, int x, int y)
+{
+    Random random(seed);
+    board.GenerateMines(x, y, random);
+}
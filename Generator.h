@@ -0,0 +1,76 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Solver.h"
+
+#include <cstdint>
+
+#define GENERATOR_TIME_BUDGET       300     // Milliseconds before giving up on a board without guesses
+
+/*
+===========================================================
+
+    Generator
+
+    Generates boards that can be solved from the first click by pure
+    logic, meaning the solver opens every safe tile without a guess.
+
+    Such boards are rare on dense fields, so every thread keeps
+    generating and testing its own candidates until one of them
+    succeeds. The first solvable board wins and the others stop.
+
+===========================================================
+*/
+class Generator
+{
+public:
+
+    struct stats_t
+    {
+        int             attempts = 0;
+        double          milliseconds = 0.0;
+        bool            noGuess = false;
+    };
+
+    // The board has to be reset but not generated yet. Returns false and leaves it untouched if no
+    // board was found in time, the caller is supposed to generate an ordinary one then.
+    bool                Generate(Board &board, int x, int y);
+    const stats_t &     Stats() const { return stats; }
+
+    // Plays the board from the first click with nothing but proven safe tiles
+    static bool         IsSolvable(Board &board, Solver &solver, int x, int y);
+
+    // The same seed and first click always give the same board, on every platform.
+    // Without a click, the board starts from SeedX(), SeedY().
+    static void         FromSeed(Board &board, uint64_t seed, int x, int y);
+    static void         FromSeed(Board &board, uint64_t seed) { FromSeed(board, seed, SeedX(board), SeedY(board)); }
+    static int          SeedX(const Board &board) { return board.Width() / 2; }
+    static int          SeedY(const Board &board) { return board.Height() / 2; }
+
+    int                 threads = 0;        // All cores if 0
+    uint64_t            seed = 0;
+    int                 timeBudget = GENERATOR_TIME_BUDGET;
+
+private:
+
+    stats_t             stats;
+    uint64_t            runs = 0;
+};
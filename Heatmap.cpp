@@ -0,0 +1,187 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Heatmap.h"
+
+#include <chrono>
+#include <utility>
+
+/*
+===================
+Heatmap::Request
+===================
+*/
+void Heatmap::Request(const Board &board)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        pending = board;
+        requested = true;
+        requests++;
+        fresh = false;
+        cancel = true;
+
+        if (!worker.joinable())
+        {
+            stop = false;
+            worker = std::thread(&Heatmap::Work, this);
+        }
+    }
+
+    wake.notify_one();
+}
+
+/*
+===================
+Heatmap::Fetch
+===================
+*/
+bool Heatmap::Fetch(std::vector<float> &probabilities)
+{
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+
+    // The worker only holds the lock for a moment, the next frame will get it
+    if (!lock.owns_lock() || !fresh)
+        return false;
+
+    fresh = false;
+
+    if (resultRequest != requests)
+        return false;
+
+    probabilities.swap(result);
+    return true;
+}
+
+/*
+===================
+Heatmap::Stop
+===================
+*/
+void Heatmap::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        cancel = true;
+    }
+
+    wake.notify_one();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+/*
+===================
+Heatmap::Work
+===================
+*/
+void Heatmap::Work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    sampler.seed = seed;
+    sampler.threads = 1;
+
+    while (!stop)
+    {
+        if (!requested)
+        {
+            wake.wait(lock);
+            continue;
+        }
+
+        // The snapshot stays at the same address, so the solver keeps up with it incrementally
+        std::swap(pending, snapshot);
+        snapshotRequest = requests;
+        requested = false;
+        cancel = false;
+
+        lock.unlock();
+        bool done = Compute();
+        lock.lock();
+
+        // A newer request has been made in the meantime
+        if (!done || cancel || snapshotRequest != requests)
+            continue;
+
+        result.swap(computed);
+        resultRequest = snapshotRequest;
+        fresh = true;
+    }
+}
+
+/*
+===================
+Heatmap::Compute
+
+Returns false if it was cancelled.
+===================
+*/
+bool Heatmap::Compute()
+{
+    if (snapshot.IsGenerated())
+        solver.Update(snapshot);
+
+    probability.cancel = &cancel;
+
+    if (probability.Compute(snapshot, solver))
+    {
+        computed = probability.Probabilities();
+        return true;
+    }
+
+    if (cancel)
+        return false;
+
+    // Too big to count, sampled until the time is up or the player moves again
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(HEATMAP_SAMPLE_TIME);
+    sampler.Start(snapshot, solver);
+
+    while (!cancel && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(HEATMAP_POLL_TIME));
+
+    sampler.Estimate(estimate);
+    sampler.Cancel();
+
+    if (cancel)
+        return false;
+
+    if (estimate.samples)
+    {
+        computed.swap(estimate.probabilities);
+        return true;
+    }
+
+    // The chain hasn't found a single valid layout yet, what the solver knows is better than nothing
+    float density = solver.UnknownTiles() ? static_cast<float>(solver.UnknownMines()) / solver.UnknownTiles() : 0.0f;
+    computed.assign(snapshot.Size(), 0.0f);
+
+    for (int i = 0; i < snapshot.Size(); i++)
+    {
+        if (solver.Knowledge(i) == Solver::MINE)
+            computed[i] = 1.0f;
+        else if (solver.Knowledge(i) == Solver::UNKNOWN)
+            computed[i] = density;
+    }
+
+    return true;
+}
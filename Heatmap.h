@@ -0,0 +1,94 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Probability.h"
+#include "Sampler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define HEATMAP_SAMPLE_TIME         250     // Milliseconds of sampling when a position is too big to count exactly
+#define HEATMAP_POLL_TIME           10      // How often sampling checks whether it was cancelled, in milliseconds
+
+/*
+===========================================================
+
+    Heatmap
+
+    Mine probabilities of the current position, computed on a worker
+    thread so the game never waits for them.
+
+    Every request replaces the previous one and cancels whatever the
+    worker is busy with, so only the latest position is ever finished.
+    The worker keeps its solver and probability cache between requests,
+    so a move usually costs little more than the tiles it opened.
+    Positions too big to count exactly are sampled for a short while
+    instead, and if even that finds nothing, tiles the solver can't
+    decide are shown at the average density.
+
+===========================================================
+*/
+class Heatmap
+{
+public:
+
+                        ~Heatmap() { Stop(); }
+
+    // Copies the board, the worker starts over with it
+    void                Request(const Board &board);
+
+    // Never waits, returns true if the result for the latest request has arrived
+    bool                Fetch(std::vector<float> &probabilities);
+
+    void                Stop();
+
+    uint64_t            seed = 0;
+
+private:
+
+    void                Work();
+    bool                Compute();
+
+    // Shared with the worker
+    Board               pending;
+    bool                requested = false;
+    unsigned            requests = 0;       // Tags every request, so a result for an older one is never shown
+    std::vector<float>  result;
+    unsigned            resultRequest = 0;  // Request the result was computed for
+    bool                fresh = false;
+    bool                stop = false;
+    std::atomic<bool>   cancel = false;
+    std::mutex          mutex;
+    std::condition_variable wake;
+    std::thread         worker;
+
+    // Owned by the worker
+    Board               snapshot;
+    unsigned            snapshotRequest = 0;
+    Solver              solver;
+    Probability         probability;
+    Sampler             sampler;
+    Sampler::estimate_t estimate;
+    std::vector<float>  computed;
+};
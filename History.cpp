@@ -0,0 +1,583 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "History.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define BLOCK_FRAME_BYTES           16      // Type and size in front, size and checksum behind
+#define SUMMARY_MAX_BYTES           (8 + HISTORY_DIFFICULTIES * (32 + HISTORY_BINS * 6))
+
+/*
+===================
+Checksum
+
+FNV-1a over the front of the block and its payload.
+===================
+*/
+static uint32_t Checksum(uint32_t type, uint32_t size, const uint8_t *data)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t front[2] = { type, size };
+
+    for (size_t i = 0; i < sizeof(front); i++)
+        hash = (hash ^ reinterpret_cast<const uint8_t *>(front)[i]) * 16777619u;
+
+    for (uint32_t i = 0; i < size; i++)
+        hash = (hash ^ data[i]) * 16777619u;
+
+    return hash;
+}
+
+/*
+===================
+Put
+===================
+*/
+template<typename type_t>
+static void Put(std::vector<uint8_t> &data, type_t value)
+{
+    size_t offset = data.size();
+    data.resize(offset + sizeof(value));
+    memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+/*
+===================
+Get
+===================
+*/
+template<typename type_t>
+static bool Get(const uint8_t *&data, const uint8_t *end, type_t &value)
+{
+    if (end - data < static_cast<ptrdiff_t>(sizeof(value)))
+        return false;
+
+    memcpy(&value, data, sizeof(value));
+    data += sizeof(value);
+
+    return true;
+}
+
+/*
+===================
+History::stats_t::Add
+===================
+*/
+void History::stats_t::Add(const game_t &game)
+{
+    games++;
+
+    if (!game.won)
+        return;
+
+    wins++;
+    wonMilliseconds += game.milliseconds;
+    bins[Bin(game.milliseconds)]++;
+
+    if (wins == 1 || game.milliseconds < best)
+        best = game.milliseconds;
+}
+
+/*
+===================
+History::stats_t::PercentileSeconds
+===================
+*/
+float History::stats_t::PercentileSeconds(float percent) const
+{
+    if (!wins)
+        return 0.0f;
+
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percent / 100.0 * wins)));
+    uint64_t count = 0;
+
+    for (int bin = 0; bin < HISTORY_BINS; bin++)
+    {
+        count += bins[bin];
+
+        // The middle of the bin, or the exact time if it's the fastest one
+        if (count >= rank)
+            return bin == Bin(best) ? std::max(best / 1000.0f, static_cast<float>(std::pow(HISTORY_BIN_GROWTH, bin) / 1000.0)) :
+                                      static_cast<float>(std::pow(HISTORY_BIN_GROWTH, bin + 0.5) / 1000.0);
+    }
+
+    return 0.0f;
+}
+
+/*
+===================
+History::Bin
+===================
+*/
+int History::Bin(uint32_t milliseconds)
+{
+    if (milliseconds <= 1)
+        return 0;
+
+    int bin = static_cast<int>(std::log(static_cast<double>(milliseconds)) / std::log(HISTORY_BIN_GROWTH));
+    return std::clamp(bin, 0, HISTORY_BINS - 1);
+}
+
+/*
+===================
+History::Open
+===================
+*/
+bool History::Open(const char *path)
+{
+    Close();
+
+    this->path = path;
+    file = std::fopen(path, "r+b");
+
+    if (!file)
+        file = std::fopen(path, "w+b");
+
+    if (!file)
+        return false;
+
+    if (!Load())
+    {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    writer = std::thread(&History::Write, this);
+    return true;
+}
+
+/*
+===================
+History::Close
+
+Waits until every game has been written.
+===================
+*/
+void History::Close()
+{
+    if (writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+
+        wake.notify_one();
+        writer.join();
+    }
+
+    if (file)
+        std::fclose(file);
+
+    file = nullptr;
+    stop = false;
+    queue.clear();
+    games = writtenGames = 0;
+    sinceSummary = 0;
+    recovered = 0;
+
+    for (int d = 0; d < HISTORY_DIFFICULTIES; d++)
+        stats[d] = written[d] = stats_t();
+}
+
+/*
+===================
+History::Append
+===================
+*/
+void History::Append(const game_t &game)
+{
+    if (!file || game.difficulty >= HISTORY_DIFFICULTIES)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats[game.difficulty].Add(game);
+        games++;
+        queue.push_back(game);
+    }
+
+    wake.notify_one();
+}
+
+/*
+===================
+History::Games
+===================
+*/
+uint64_t History::Games() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return games;
+}
+
+/*
+===================
+History::Stats
+===================
+*/
+History::stats_t History::Stats(int difficulty) const
+{
+    if (difficulty < 0 || difficulty >= HISTORY_DIFFICULTIES)
+        return stats_t();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats[difficulty];
+}
+
+/*
+===================
+History::Load
+
+Reads backwards from the end to the last summary, all of which fits in a window of known size.
+Only a torn or damaged file is read from the start.
+===================
+*/
+bool History::Load()
+{
+    header_t header = {};
+    uint64_t size = std::filesystem::file_size(path);
+
+    // A new file, or one that didn't even get its header written
+    if (size < sizeof(header))
+    {
+        header.magic = HISTORY_MAGIC;
+        header.version = HISTORY_VERSION;
+        header.gameBytes = sizeof(game_t);
+
+        std::fseek(file, 0, SEEK_SET);
+
+        if (std::fwrite(&header, sizeof(header), 1, file) != 1 || std::fflush(file))
+            return false;
+
+        size = sizeof(header);
+    }
+    else
+    {
+        std::fseek(file, 0, SEEK_SET);
+
+        if (std::fread(&header, sizeof(header), 1, file) != 1)
+            return false;
+
+        // Not a file of ours, which is better left alone
+        if (header.magic != HISTORY_MAGIC || header.version != HISTORY_VERSION || header.gameBytes != sizeof(game_t))
+            return false;
+    }
+
+    uint64_t window = std::min<uint64_t>(size - sizeof(header), HISTORY_SUMMARY_GAMES * (sizeof(game_t) + BLOCK_FRAME_BYTES) +
+                                                                SUMMARY_MAX_BYTES + BLOCK_FRAME_BYTES);
+    std::vector<uint8_t> buffer(static_cast<size_t>(window));
+    std::vector<game_t> tail;
+    bool summary = false, intact = true;
+
+    std::fseek(file, -static_cast<long>(window), SEEK_END);
+
+    if (window && std::fread(buffer.data(), buffer.size(), 1, file) != 1)
+        return false;
+
+    size_t position = buffer.size();
+
+    while (position && !summary)
+    {
+        uint32_t type, blockSize, checksum, frontSize;
+
+        if (position < BLOCK_FRAME_BYTES)
+        {
+            intact = false;
+            break;
+        }
+
+        memcpy(&blockSize, buffer.data() + position - 8, 4);
+        memcpy(&checksum, buffer.data() + position - 4, 4);
+
+        if (blockSize > position - BLOCK_FRAME_BYTES)
+        {
+            intact = false;
+            break;
+        }
+
+        size_t start = position - BLOCK_FRAME_BYTES - blockSize;
+        const uint8_t *payload = buffer.data() + start + 8;
+
+        memcpy(&type, buffer.data() + start, 4);
+        memcpy(&frontSize, buffer.data() + start + 4, 4);
+
+        if (frontSize != blockSize || Checksum(type, blockSize, payload) != checksum)
+        {
+            intact = false;
+            break;
+        }
+
+        if (type == HISTORY_GAME && blockSize == sizeof(game_t))
+        {
+            tail.emplace_back();
+            memcpy(&tail.back(), payload, sizeof(game_t));
+        }
+        else if (type == HISTORY_SUMMARY)
+        {
+            const uint8_t *data = payload, *end = payload + blockSize;
+            summary = Get(data, end, games);
+
+            for (int d = 0; d < HISTORY_DIFFICULTIES && summary; d++)
+            {
+                stats_t &s = stats[d];
+                uint32_t count = 0;
+
+                summary = Get(data, end, s.games) && Get(data, end, s.wins) && Get(data, end, s.best) &&
+                          Get(data, end, s.wonMilliseconds) && Get(data, end, count);
+
+                for (uint32_t i = 0; i < count && summary; i++)
+                {
+                    uint16_t bin;
+                    uint32_t n;
+                    summary = Get(data, end, bin) && Get(data, end, n) && bin < HISTORY_BINS;
+
+                    if (summary)
+                        s.bins[bin] = n;
+                }
+            }
+
+            if (!summary)
+            {
+                intact = false;
+                break;
+            }
+        }
+
+        position = start;
+    }
+
+    // Without a summary, the window has to reach back to the header
+    if (!summary && window != size - sizeof(header))
+        intact = false;
+
+    if (!intact)
+    {
+        uint64_t end = 0;
+
+        if (!Scan(end))
+            return false;
+
+        if (end < size)
+        {
+            recovered = size - end;
+            std::fclose(file);
+            file = nullptr;
+
+            std::error_code error;
+            std::filesystem::resize_file(path, end, error);
+            file = std::fopen(path.c_str(), "r+b");
+
+            if (error || !file)
+                return false;
+        }
+    }
+    else
+    {
+        if (!summary)
+        {
+            games = 0;
+
+            for (stats_t &s : stats)
+                s = stats_t();
+        }
+
+        for (auto game = tail.rbegin(); game != tail.rend(); ++game)
+        {
+            if (game->difficulty < HISTORY_DIFFICULTIES)
+                stats[game->difficulty].Add(*game);
+
+            games++;
+        }
+
+        sinceSummary = static_cast<int>(tail.size());
+    }
+
+    for (int d = 0; d < HISTORY_DIFFICULTIES; d++)
+        written[d] = stats[d];
+
+    writtenGames = games;
+
+    return std::fseek(file, 0, SEEK_END) == 0;
+}
+
+/*
+===================
+History::Scan
+
+Adds up every game from the start, and finds where the intact blocks end.
+===================
+*/
+bool History::Scan(uint64_t &end)
+{
+    games = 0;
+    sinceSummary = 0;
+
+    for (stats_t &s : stats)
+        s = stats_t();
+
+    std::fseek(file, sizeof(header_t), SEEK_SET);
+    end = sizeof(header_t);
+
+    std::vector<uint8_t> payload;
+
+    for (;;)
+    {
+        uint32_t front[2], back[2];
+
+        if (std::fread(front, sizeof(front), 1, file) != 1 || front[1] > SUMMARY_MAX_BYTES)
+            break;
+
+        payload.resize(front[1]);
+
+        if ((front[1] && std::fread(payload.data(), front[1], 1, file) != 1) || std::fread(back, sizeof(back), 1, file) != 1)
+            break;
+
+        if (back[0] != front[1] || back[1] != Checksum(front[0], front[1], payload.data()))
+            break;
+
+        if (front[0] == HISTORY_GAME && front[1] == sizeof(game_t))
+        {
+            game_t game;
+            memcpy(&game, payload.data(), sizeof(game));
+
+            if (game.difficulty < HISTORY_DIFFICULTIES)
+                stats[game.difficulty].Add(game);
+
+            games++;
+            sinceSummary++;
+        }
+        else if (front[0] == HISTORY_SUMMARY)
+        {
+            sinceSummary = 0;
+        }
+
+        end += BLOCK_FRAME_BYTES + front[1];
+    }
+
+    std::clearerr(file);
+    return true;
+}
+
+/*
+===================
+History::Write
+
+The writer thread. Whatever has been queued by the time it wakes up is written and synced together.
+===================
+*/
+void History::Write()
+{
+    std::vector<game_t> batch;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stop || !queue.empty(); });
+
+            if (queue.empty())
+                return;
+
+            batch.swap(queue);
+        }
+
+        for (const game_t &game : batch)
+        {
+            std::vector<uint8_t> payload(sizeof(game));
+            memcpy(payload.data(), &game, sizeof(game));
+            WriteBlock(HISTORY_GAME, payload);
+
+            written[game.difficulty].Add(game);
+            writtenGames++;
+
+            if (++sinceSummary >= HISTORY_SUMMARY_GAMES)
+                WriteSummary();
+        }
+
+        batch.clear();
+        std::fflush(file);
+
+#ifdef _WIN32
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif
+    }
+}
+
+/*
+===================
+History::WriteBlock
+===================
+*/
+bool History::WriteBlock(uint32_t type, const std::vector<uint8_t> &payload)
+{
+    uint32_t size = static_cast<uint32_t>(payload.size());
+    uint32_t front[2] = { type, size };
+    uint32_t back[2] = { size, Checksum(type, size, payload.data()) };
+
+    return std::fwrite(front, sizeof(front), 1, file) == 1 && (!size || std::fwrite(payload.data(), size, 1, file) == 1) &&
+           std::fwrite(back, sizeof(back), 1, file) == 1;
+}
+
+/*
+===================
+History::WriteSummary
+
+Totals of everything written so far, with only the histogram bins that aren't empty.
+===================
+*/
+void History::WriteSummary()
+{
+    std::vector<uint8_t> payload;
+    Put(payload, writtenGames);
+
+    for (const stats_t &s : written)
+    {
+        Put(payload, s.games);
+        Put(payload, s.wins);
+        Put(payload, s.best);
+        Put(payload, s.wonMilliseconds);
+        Put(payload, static_cast<uint32_t>(HISTORY_BINS - std::count(s.bins.begin(), s.bins.end(), 0u)));
+
+        for (int bin = 0; bin < HISTORY_BINS; bin++)
+        {
+            if (s.bins[bin])
+            {
+                Put(payload, static_cast<uint16_t>(bin));
+                Put(payload, s.bins[bin]);
+            }
+        }
+    }
+
+    WriteBlock(HISTORY_SUMMARY, payload);
+    sinceSummary = 0;
+}
@@ -0,0 +1,155 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define HISTORY_MAGIC               0x4847464D // "MFGH"
+#define HISTORY_VERSION             1
+#define HISTORY_GAME                0x454D4147 // "GAME", block types
+#define HISTORY_SUMMARY             0x4D4D5553 // "SUMM"
+#define HISTORY_DIFFICULTIES        5       // Indexed like Settings::difficulty_t
+#define HISTORY_SUMMARY_GAMES       1024    // Games between summary blocks
+#define HISTORY_BINS                2240    // Time histogram, each bin 1% wider than the one before
+#define HISTORY_BIN_GROWTH          1.01
+
+/*
+===========================================================
+
+    History
+
+    Every finished game, appended to a file that is never rewritten.
+
+    The file is a header followed by blocks, each framed by its type
+    and size in front and its size and checksum behind, so it can be
+    read from either end. Every HISTORY_SUMMARY_GAMES games a summary
+    block carries the totals of all games before it. Opening reads the
+    file backwards to the last summary and only adds up the games after
+    it, so it takes the same time for a thousand games as for a million.
+
+    A block torn by a crash fails its checksum. It's cut off the next
+    time the file is opened, together with anything after it.
+
+    Append() only updates the totals in memory and queues the game, a
+    thread writes and syncs the file. Queries never touch the file.
+
+===========================================================
+*/
+class History
+{
+public:
+
+    struct header_t
+    {
+        uint32_t        magic;
+        uint32_t        version;
+        uint32_t        gameBytes;
+        uint32_t        reserved;
+    };
+
+    struct game_t
+    {
+        uint64_t        seed = 0;           // 0 if the board can't be made again
+        int64_t         date = 0;           // Seconds since the epoch, when the game ended
+        uint32_t        milliseconds = 0;
+        uint16_t        width = 0;
+        uint16_t        height = 0;
+        uint16_t        mines = 0;
+        uint16_t        threeBV = 0;
+        uint16_t        leftClicks = 0;
+        uint16_t        rightClicks = 0;
+        uint16_t        chordClicks = 0;
+        uint8_t         difficulty = 0;
+        uint8_t         won = 0;
+        uint16_t        firstClick = 0;     // Tile index, the seed makes the board from here
+        uint16_t        reserved = 0;
+    };
+
+    struct stats_t
+    {
+        uint64_t        games = 0;
+        uint64_t        wins = 0;
+        uint32_t        best = 0;           // Milliseconds of the fastest win
+        uint64_t        wonMilliseconds = 0;
+        std::vector<uint32_t> bins = std::vector<uint32_t>(HISTORY_BINS, 0);
+
+        float           WinRate() const { return games ? static_cast<float>(wins) / games : 0.0f; }
+        float           MeanSeconds() const { return wins ? static_cast<float>(wonMilliseconds) / wins / 1000.0f : 0.0f; }
+
+        // Time of won games, within half a percent
+        float           PercentileSeconds(float percent) const;
+
+        void            Add(const game_t &game);
+    };
+
+                        History() = default;
+                        History(const History &) = delete;
+                        ~History() { Close(); }
+
+    History &           operator=(const History &) = delete;
+
+    // Creates the file if there is none
+    bool                Open(const char *path);
+    void                Close();
+    bool                IsOpen() const { return file != nullptr; }
+
+    void                Append(const game_t &game);
+
+    uint64_t            Games() const;
+    stats_t             Stats(int difficulty) const;
+
+    // Bytes of torn blocks that were cut off when the file was opened
+    uint64_t            RecoveredBytes() const { return recovered; }
+
+    static int          Bin(uint32_t milliseconds);
+
+private:
+
+    bool                Load();
+    bool                Scan(uint64_t &end);
+    void                Write();
+    bool                WriteBlock(uint32_t type, const std::vector<uint8_t> &payload);
+    void                WriteSummary();
+
+    std::string         path;
+    std::FILE *         file = nullptr;
+    uint64_t            recovered = 0;
+
+    // What queries see, including games still waiting to be written
+    mutable std::mutex  mutex;
+    stats_t             stats[HISTORY_DIFFICULTIES];
+    uint64_t            games = 0;
+
+    std::condition_variable wake;
+    std::vector<game_t> queue;
+    std::thread         writer;
+    bool                stop = false;
+
+    // What has reached the file, only touched by the writer
+    stats_t             written[HISTORY_DIFFICULTIES];
+    uint64_t            writtenGames = 0;
+    int                 sinceSummary = 0;
+};
@@ -74,6 +74,7 @@ Free
 */
 bool Free()
 {
+    game.SaveGame();
     game.SaveSettings();
     return true;
 }
@@ -0,0 +1,112 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Metrics.h"
+
+/*
+===================
+Metrics::Compute
+===================
+*/
+void Metrics::Compute(const Board &board)
+{
+    labels.assign(board.Size(), -1);
+    covered.assign(board.Size(), 0);
+    openings = 0;
+    isolated = 0;
+    openingTiles = 0;
+
+    // Same as Tile::HasNoNearestMines, but this runs for every tile and its neighbors
+    auto isZero = [&board](int index) { return board[index].type == Tile::EMPTY && !board[index].nearestMines; };
+
+    for (int i = 0; i < board.Size(); i++)
+    {
+        if (labels[i] >= 0 || !isZero(i))
+            continue;
+
+        labels[i] = openings;
+        stack.push_back(i);
+
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+
+            for (int y = board.Y(index) - 1; y <= board.Y(index) + 1; y++)
+            {
+                for (int x = board.X(index) - 1; x <= board.X(index) + 1; x++)
+                {
+                    if (!board.IsInside(x, y))
+                        continue;
+
+                    int neighbor = board.Index(x, y);
+                    covered[neighbor] = 1;
+
+                    if (labels[neighbor] < 0 && isZero(neighbor))
+                    {
+                        labels[neighbor] = openings;
+                        stack.push_back(neighbor);
+                    }
+                }
+            }
+        }
+
+        openings++;
+    }
+
+    for (int i = 0; i < board.Size(); i++)
+    {
+        if (board[i].type == Tile::MINED)
+            continue;
+
+        if (covered[i])
+            openingTiles++;
+        else
+            isolated++;
+    }
+}
+
+/*
+===================
+Metrics::SolvedThreeBV
+===================
+*/
+int Metrics::SolvedThreeBV(const Board &board) const
+{
+    std::vector<uint8_t> opened(openings, 0);
+    int solved = 0;
+
+    for (int i = 0; i < board.Size() && i < static_cast<int>(labels.size()); i++)
+    {
+        if (board[i].state != Tile::OPEN || board[i].type == Tile::MINED)
+            continue;
+
+        if (labels[i] >= 0 && !opened[labels[i]])
+        {
+            opened[labels[i]] = 1;
+            solved++;
+        }
+        else if (!covered[i])
+        {
+            solved++;
+        }
+    }
+
+    return solved;
+}
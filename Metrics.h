@@ -0,0 +1,65 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Board.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+===========================================================
+
+    Metrics
+
+    How hard a generated board is, in a single pass over the tiles.
+
+    An opening is a connected area of tiles without adjacent mines,
+    which a single click opens together with the numbers around it.
+    Numbers that don't border any opening have to be clicked one by
+    one. The sum of both is the 3BV, the fewest clicks that solve the
+    board without flags.
+
+===========================================================
+*/
+class Metrics
+{
+public:
+
+    // The board has to be generated
+    void                Compute(const Board &board);
+
+    int                 ThreeBV() const { return openings + isolated; }
+    int                 Openings() const { return openings; }
+    int                 IsolatedNumbers() const { return isolated; }
+    int                 OpeningTiles() const { return openingTiles; }
+
+    // 3BV that has been cleared on the board so far, also for lost games
+    int                 SolvedThreeBV(const Board &board) const;
+
+private:
+
+    std::vector<int>    labels;             // Opening of every tile without adjacent mines, -1 otherwise
+    std::vector<uint8_t> covered;           // Opened by some opening
+    std::vector<int>    stack;
+    int                 openings = 0;
+    int                 isolated = 0;
+    int                 openingTiles = 0;
+};
@@ -0,0 +1,210 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "MoveHistory.h"
+
+#include <algorithm>
+
+/*
+===================
+MoveHistory::Clear
+===================
+*/
+void MoveHistory::Clear()
+{
+    positions.clear();
+    changes.clear();
+    copies.clear();
+    current = 0;
+    journal = 0;
+}
+
+/*
+===================
+MoveHistory::Start
+===================
+*/
+void MoveHistory::Start(const Board &board)
+{
+    size = board.Size();
+    generation = board.Generation();
+    journal = board.Changes().size();
+
+    tiles.resize(size);
+
+    for (int i = 0; i < size; i++)
+        tiles[i] = board[i].state;
+
+    positions.clear();
+    positions.push_back({ 0, board.Counters() });
+    changes.clear();
+    copies.clear();
+    copies.push_back({ 0, 0, tiles });
+    current = 0;
+
+    seen.assign(size, 0);
+    commits = 0;
+}
+
+/*
+===================
+MoveHistory::Commit
+===================
+*/
+bool MoveHistory::Commit(const Board &board)
+{
+    const std::vector<int> &journaled = board.Changes();
+
+    if (positions.empty() || board.Generation() != generation || board.Size() != size || journaled.size() < journal)
+    {
+        Start(board);
+        return false;
+    }
+
+    commits++;
+    collected.clear();
+
+    // A tile may change more than once in a move, or end up as it was
+    for (; journal < journaled.size(); journal++)
+    {
+        int index = journaled[journal];
+
+        if (seen[index] == commits)
+            continue;
+
+        seen[index] = commits;
+
+        if (board[index].state != tiles[index])
+            collected.push_back({ index, tiles[index], board[index].state });
+    }
+
+    if (collected.empty())
+        return false;
+
+    // The moves that were undone go, with the copies taken after them
+    changes.resize(End(current));
+    positions.resize(current + 1);
+
+    while (copies.back().position > current)
+        copies.pop_back();
+
+    positions.push_back({ changes.size(), board.Counters() });
+    changes.insert(changes.end(), collected.begin(), collected.end());
+    current++;
+
+    for (const change_t &change : collected)
+        tiles[change.index] = change.after;
+
+    if (changes.size() - copies.back().end >= static_cast<size_t>(size))
+        copies.push_back({ current, changes.size(), tiles });
+
+    return true;
+}
+
+/*
+===================
+MoveHistory::Undo
+===================
+*/
+bool MoveHistory::Undo(Board &board)
+{
+    if (!CanUndo() || board.Generation() != generation)
+        return false;
+
+    Apply(board, current - 1, current, true);
+    current--;
+
+    return true;
+}
+
+/*
+===================
+MoveHistory::Redo
+===================
+*/
+bool MoveHistory::Redo(Board &board)
+{
+    if (!CanRedo() || board.Generation() != generation)
+        return false;
+
+    Apply(board, current + 1, current + 1, false);
+    current++;
+
+    return true;
+}
+
+/*
+===================
+MoveHistory::Apply
+
+Puts the tiles the move changed into their states at the position, they are all that differ between the two positions.
+===================
+*/
+void MoveHistory::Apply(Board &board, size_t position, size_t move, bool undo)
+{
+    for (size_t i = positions[move].first; i < End(move); i++)
+    {
+        const change_t &change = changes[i];
+        Tile::state_t state = undo ? change.before : change.after;
+
+        board.RestoreTile(change.index, state);
+        tiles[change.index] = state;
+    }
+
+    board.RestoreCounters(positions[position].counters);
+
+    // The board's journal has them now, they aren't a new move
+    journal = board.Changes().size();
+}
+
+/*
+===================
+MoveHistory::States
+
+Starts from the last copy of all tiles at or before the position and goes forward from there.
+===================
+*/
+void MoveHistory::States(size_t position, std::vector<Tile::state_t> &states) const
+{
+    auto after = std::upper_bound(copies.begin(), copies.end(), position,
+                                  [](size_t value, const copy_t &copy) { return value < copy.position; });
+    const copy_t &copy = *(after - 1);
+
+    states = copy.tiles;
+
+    for (size_t i = copy.end; i < End(position); i++)
+        states[changes[i].index] = changes[i].after;
+}
+
+/*
+===================
+MoveHistory::Bytes
+===================
+*/
+size_t MoveHistory::Bytes() const
+{
+    size_t bytes = positions.capacity() * sizeof(position_t) + changes.capacity() * sizeof(change_t) +
+                   copies.capacity() * sizeof(copy_t) + tiles.capacity() + seen.capacity() * sizeof(unsigned) +
+                   collected.capacity() * sizeof(change_t);
+
+    for (const copy_t &copy : copies)
+        bytes += copy.tiles.capacity();
+
+    return bytes;
+}
@@ -0,0 +1,124 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Board.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+===========================================================
+
+    MoveHistory
+
+    Every position of a game, for undoing and redoing moves.
+
+    A move is kept as the tiles it changed, each with its state before
+    and after, and the counters of the position it leads to. The changes
+    of all moves go into one array, so a move takes 8 bytes for every
+    tile it changed and 32 for its position, and the history can grow
+    for as long as the game goes on.
+
+    Undo and redo only put back the tiles the move changed, and the
+    counters of the position they go to.
+
+    To read any position without going through the whole game, all tiles
+    are copied whenever the moves since the last copy changed as many
+    tiles as the field has. The copies take an eighth of what the changes
+    take at most, and reading a position starts from the copy before it.
+
+    Commit() picks up whatever the board's journal has got since the
+    last call, so it can follow a board that is played by anything.
+    A board that was reset, or set with SetStates, starts it over.
+
+===========================================================
+*/
+class MoveHistory
+{
+public:
+
+    struct change_t
+    {
+        int             index;
+        Tile::state_t   before;
+        Tile::state_t   after;
+    };
+
+    void                Clear();
+
+    // The board as it is becomes the first position
+    void                Start(const Board &board);
+
+    // Adds the changes since the last call as a move, dropping the moves that were undone.
+    // Returns false if nothing has changed.
+    bool                Commit(const Board &board);
+
+    bool                Undo(Board &board);
+    bool                Redo(Board &board);
+    bool                CanUndo() const { return current > 0; }
+    bool                CanRedo() const { return current + 1 < positions.size(); }
+
+    // Any position can be read without touching the board, 0 is the first one
+    size_t              Positions() const { return positions.size(); }
+    size_t              Current() const { return current; }
+    void                States(size_t position, std::vector<Tile::state_t> &states) const;
+    const Board::counters_t &Counters(size_t position) const { return positions[position].counters; }
+
+    // Tiles that the move to this position changed, in the order they were first changed
+    const change_t *    Changed(size_t position) const { return changes.data() + positions[position].first; }
+    size_t              ChangedTiles(size_t position) const { return End(position) - positions[position].first; }
+
+    // Memory held by the history, with the copies of all tiles
+    size_t              Bytes() const;
+
+private:
+
+    struct position_t
+    {
+        size_t          first;              // Its move's changes start here
+        Board::counters_t counters;
+    };
+
+    struct copy_t
+    {
+        size_t          position;
+        size_t          end;                // Changes up to here are in it
+        std::vector<Tile::state_t> tiles;
+    };
+
+    size_t              End(size_t position) const { return position + 1 < positions.size() ? positions[position + 1].first : changes.size(); }
+    void                Apply(Board &board, size_t position, size_t move, bool undo);
+
+    std::vector<position_t> positions;
+    std::vector<change_t> changes;
+    std::vector<copy_t> copies;
+    size_t              current = 0;
+
+    std::vector<Tile::state_t> tiles;       // Of the current position
+    int                 size = 0;
+    unsigned            generation = 0;     // Of the board that is followed
+    size_t              journal = 0;        // Changes of the board that are already in
+
+    std::vector<unsigned> seen;             // Commit that last saw a tile, to skip repeated changes
+    unsigned            commits = 0;
+    std::vector<change_t> collected;
+};
@@ -0,0 +1,241 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Pack.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/*
+===================
+Pack::Open
+===================
+*/
+bool Pack::Open(const char *path)
+{
+    Close();
+
+#ifdef _WIN32
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        file = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(file, &fileSize) || !fileSize.QuadPart)
+    {
+        Close();
+        return false;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (!mapping)
+    {
+        Close();
+        return false;
+    }
+
+    data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+
+    if (fstat(fd, &st) || !st.st_size)
+    {
+        close(fd);
+        return false;
+    }
+
+    void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (view == MAP_FAILED)
+        return false;
+
+    data = static_cast<const uint8_t *>(view);
+    size = static_cast<size_t>(st.st_size);
+#endif
+
+    if (!data || size < sizeof(header_t))
+    {
+        Close();
+        return false;
+    }
+
+    const header_t *header = reinterpret_cast<const header_t *>(data);
+
+    if (header->magic != PACK_MAGIC || header->version != PACK_VERSION)
+    {
+        Close();
+        return false;
+    }
+
+    if (sizeof(header_t) + static_cast<uint64_t>(header->entries) * sizeof(entry_t) > size)
+    {
+        Close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const entry_t *>(data + sizeof(header_t));
+    count = header->entries;
+
+    // Everything is validated once, so lookups can trust the table
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const entry_t &entry = entries[i];
+
+        if (entry.offset > size || entry.size > size - entry.offset || entry.name >= size ||
+            !memchr(data + entry.name, 0, size - entry.name))
+        {
+            Close();
+            return false;
+        }
+
+        if (entry.type == TEXTURE && (entry.format != 32 || entry.size < static_cast<uint64_t>(entry.width) * entry.height * 4))
+        {
+            Close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+===================
+Pack::Close
+===================
+*/
+void Pack::Close()
+{
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+
+    if (mapping)
+        CloseHandle(mapping);
+
+    if (file)
+        CloseHandle(file);
+
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (data)
+        munmap(const_cast<uint8_t *>(data), size);
+#endif
+
+    data = nullptr;
+    size = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+/*
+===================
+Pack::Find
+
+Binary search over the entries, which the packer sorts by hash.
+===================
+*/
+const Pack::entry_t *Pack::Find(const char *name) const
+{
+    if (!data)
+        return nullptr;
+
+    uint64_t hash = Hash(name);
+    uint32_t first = 0;
+    uint32_t last = count;
+
+    while (first < last)
+    {
+        uint32_t middle = first + (last - first) / 2;
+
+        if (entries[middle].hash < hash)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    // The hash only narrows it down, the name decides
+    for (; first < count && entries[first].hash == hash; first++)
+        if (IsSameName(Name(entries[first]), name))
+            return &entries[first];
+
+    return nullptr;
+}
+
+/*
+===================
+Pack::IsSameName
+
+Compares names the way they are hashed.
+===================
+*/
+bool Pack::IsSameName(const char *a, const char *b)
+{
+    for (;; a++, b++)
+    {
+        if (Normalize(*a) != Normalize(*b))
+            return false;
+
+        if (!*a)
+            return true;
+    }
+}
+
+/*
+===================
+Pack::Hash
+
+Case-insensitive FNV-1a, both slash styles hash the same.
+===================
+*/
+uint64_t Pack::Hash(const char *name)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (; *name; name++)
+    {
+        hash ^= static_cast<uint8_t>(Normalize(*name));
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
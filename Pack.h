@@ -0,0 +1,106 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#define PACK_MAGIC                  0x4B50464D // "MFPK"
+#define PACK_VERSION                1
+#define PACK_ALIGNMENT              64
+
+/*
+===========================================================
+
+    Pack
+
+    A read-only, memory-mapped asset pack. Textures are stored as
+    top-down RGBA8 pixels, everything else is stored as the file was.
+    The engine only creates textures from files it decodes itself, so
+    the game keeps loading them from DATA_PACK.
+
+    Layout: header, entries sorted by name hash, names, aligned data.
+
+===========================================================
+*/
+class Pack
+{
+public:
+
+    enum type_t : uint32_t
+    {
+        RAW,
+        TEXTURE
+    };
+
+    struct header_t
+    {
+        uint32_t        magic;
+        uint32_t        version;
+        uint32_t        entries;
+        uint32_t        reserved;
+    };
+
+    struct entry_t
+    {
+        uint64_t        hash;
+        uint64_t        offset;
+        uint64_t        size;
+        uint32_t        name;           // Offset of the null-terminated name
+        type_t          type;
+        uint32_t        width;          // Texture width
+        uint32_t        height;         // Texture height
+        uint32_t        format;         // Bits per texture pixel
+        uint32_t        reserved;
+    };
+
+                        Pack() = default;
+                        ~Pack() { Close(); }
+
+                        Pack(const Pack &) = delete;
+    Pack &              operator=(const Pack &) = delete;
+
+    bool                Open(const char *path);
+    void                Close();
+    bool                IsOpen() const { return data != nullptr; }
+
+    const entry_t *     Find(const char *name) const;
+    const void *        Data(const entry_t &entry) const { return data + entry.offset; }
+    const char *        Name(const entry_t &entry) const { return reinterpret_cast<const char *>(data + entry.name); }
+
+    static uint64_t     Hash(const char *name);
+
+private:
+
+    static bool         IsSameName(const char *a, const char *b);
+
+    // Lowercase with forward slashes
+    static char         Normalize(char c) { return c == '\\' ? '/' : c >= 'A' && c <= 'Z' ? static_cast<char>(c + 'a' - 'A') : c; }
+
+    const uint8_t *     data = nullptr;
+    size_t              size = 0;
+    const entry_t *     entries = nullptr;
+    uint32_t            count = 0;
+
+#ifdef _WIN32
+    void *              file = nullptr;
+    void *              mapping = nullptr;
+#endif
+};
@@ -0,0 +1,495 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Probability.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+/*
+===========================================================
+
+    enumeration_t
+
+    Backtracking state for a single component. Tiles are assigned in
+    the order they were reached from the first one, so most numbers are
+    complete early and bad branches are cut quickly.
+
+===========================================================
+*/
+struct enumeration_t
+{
+    int                 tiles = 0;
+    int                 nodes = 0;
+    int                 maxNodes = 0;
+    const std::atomic<bool> *cancel = nullptr;
+    int                 mines = 0;
+    std::vector<std::vector<int>> tileNumbers;  // Numbers every tile is next to
+    std::vector<int>    need;                   // Mines every number still needs
+    std::vector<int>    mined;                  // Mines assigned next to every number
+    std::vector<int>    left;                   // Tiles not assigned next to every number
+    std::vector<uint64_t> bits;                 // Assigned mines
+    std::vector<double> *counts = nullptr;
+    std::vector<double> *tileCounts = nullptr;
+
+    bool                Step(int tile);
+};
+
+/*
+===================
+enumeration_t::Step
+
+Returns false once there were too many steps, or it was cancelled.
+===================
+*/
+bool enumeration_t::Step(int tile)
+{
+    if (++nodes > maxNodes)
+        return false;
+
+    if (cancel && !(nodes & 4095) && *cancel)
+        return false;
+
+    if (tile == tiles)
+    {
+        (*counts)[mines] += 1.0;
+        double *row = &(*tileCounts)[static_cast<size_t>(mines) * tiles];
+
+        for (size_t i = 0; i < bits.size(); i++)
+            for (uint64_t word = bits[i]; word; word &= word - 1)
+                row[i * 64 + std::countr_zero(word)] += 1.0;
+
+        return true;
+    }
+
+    for (int value = 0; value <= 1; value++)
+    {
+        bool valid = true;
+
+        for (int number : tileNumbers[tile])
+        {
+            left[number]--;
+            mined[number] += value;
+
+            if (mined[number] > need[number] || mined[number] + left[number] < need[number])
+                valid = false;
+        }
+
+        bool completed = true;
+
+        if (valid)
+        {
+            if (value)
+                bits[tile / 64] |= 1ull << (tile % 64);
+
+            mines += value;
+            completed = Step(tile + 1);
+            mines -= value;
+            bits[tile / 64] &= ~(1ull << (tile % 64));
+        }
+
+        for (int number : tileNumbers[tile])
+        {
+            left[number]++;
+            mined[number] -= value;
+        }
+
+        if (!completed)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+===================
+Convolve
+
+Distribution of the sum of two independent mine counts, scaled so the largest value is 1.
+===================
+*/
+static std::vector<double> Convolve(const std::vector<double> &a, const std::vector<double> &b)
+{
+    std::vector<double> result(a.size() + b.size() - 1, 0.0);
+    double largest = 0.0;
+
+    for (size_t i = 0; i < a.size(); i++)
+        for (size_t j = 0; j < b.size(); j++)
+            result[i + j] += a[i] * b[j];
+
+    for (double value : result)
+        largest = std::max(largest, value);
+
+    if (largest > 0.0)
+        for (double &value : result)
+            value /= largest;
+
+    return result;
+}
+
+/*
+===================
+Probability::Compute
+
+Returns false if the visible numbers contradict each other, a component is too big to count, or it was cancelled.
+===================
+*/
+bool Probability::Compute(const Board &board, const Solver &solver)
+{
+    probabilities.assign(board.Size(), 0.0f);
+    components = 0;
+    cacheHits = 0;
+    tooBig = false;
+
+    // Nothing is known before the first click
+    if (!board.IsGenerated())
+    {
+        interior = board.Size() ? static_cast<float>(board.Mines()) / board.Size() : 0.0f;
+        std::fill(probabilities.begin(), probabilities.end(), interior);
+        return true;
+    }
+
+    if (generation != board.Generation() || reverts != board.Reverts())
+    {
+        generation = board.Generation();
+        reverts = board.Reverts();
+        cache.clear();
+    }
+
+    parents.assign(board.Size(), -1);
+    constraints.clear();
+    int frontier = 0;
+
+    // Every open number with unknown neighbors joins them into one component
+    for (int i = 0; i < board.Size(); i++)
+    {
+        const Tile &tile = board[i];
+
+        if (tile.state != Tile::OPEN || tile.type == Tile::MINED)
+            continue;
+
+        constraint_t constraint;
+        constraint.mines = tile.nearestMines;
+
+        for (int y = board.Y(i) - 1; y <= board.Y(i) + 1; y++)
+        {
+            for (int x = board.X(i) - 1; x <= board.X(i) + 1; x++)
+            {
+                if (!board.IsInside(x, y))
+                    continue;
+
+                int neighbor = board.Index(x, y);
+
+                if (solver.Knowledge(neighbor) == Solver::MINE)
+                    constraint.mines--;
+                else if (solver.Knowledge(neighbor) == Solver::UNKNOWN)
+                    constraint.tiles.push_back(neighbor);
+            }
+        }
+
+        // A number the solver has settled still has to agree with it
+        if (constraint.tiles.empty())
+        {
+            if (constraint.mines)
+                return false;
+
+            continue;
+        }
+
+        for (int neighbor : constraint.tiles)
+        {
+            if (parents[neighbor] < 0)
+            {
+                parents[neighbor] = neighbor;
+                frontier++;
+            }
+
+            parents[Find(neighbor)] = Find(constraint.tiles[0]);
+        }
+
+        constraints.push_back(std::move(constraint));
+    }
+
+    // Groups tiles and numbers by component, in board order so the same component always gets the same key
+    std::vector<int> groupOf(board.Size(), -1);
+    std::vector<std::vector<int>> groupTiles;
+    std::vector<std::vector<const constraint_t *>> groupNumbers;
+
+    for (int i = 0; i < board.Size(); i++)
+    {
+        if (parents[i] < 0)
+            continue;
+
+        int root = Find(i);
+
+        if (groupOf[root] < 0)
+        {
+            groupOf[root] = static_cast<int>(groupTiles.size());
+            groupTiles.emplace_back();
+            groupNumbers.emplace_back();
+        }
+
+        groupTiles[groupOf[root]].push_back(i);
+    }
+
+    for (const constraint_t &constraint : constraints)
+        groupNumbers[groupOf[Find(constraint.tiles[0])]].push_back(&constraint);
+
+    std::vector<component_t *> used;
+
+    for (size_t g = 0; g < groupTiles.size(); g++)
+    {
+        std::vector<int> key = groupTiles[g];
+        key.push_back(-1);
+
+        for (const constraint_t *constraint : groupNumbers[g])
+        {
+            key.push_back(constraint->mines);
+            key.insert(key.end(), constraint->tiles.begin(), constraint->tiles.end());
+            key.push_back(-1);
+        }
+
+        // FNV-1a over the key
+        uint64_t hash = 14695981039346656037ull;
+
+        for (int value : key)
+            hash = (hash ^ static_cast<uint32_t>(value)) * 1099511628211ull;
+
+        auto it = cache.find(hash);
+
+        if (it != cache.end() && it->second.key == key)
+        {
+            cacheHits++;
+        }
+        else
+        {
+            component_t component;
+            component.key = std::move(key);
+            component.tiles = groupTiles[g];
+
+            if (!Enumerate(component, groupNumbers[g]))
+            {
+                tooBig = !cancel || !*cancel;
+                return false;
+            }
+
+            it = cache.insert_or_assign(hash, std::move(component)).first;
+        }
+
+        it->second.used = true;
+        used.push_back(&it->second);
+    }
+
+    components = static_cast<int>(used.size());
+
+    // Mine counts of all components before and after each one
+    std::vector<std::vector<double>> prefix(used.size() + 1), suffix(used.size() + 1);
+    prefix[0] = suffix[used.size()] = { 1.0 };
+
+    for (size_t c = 0; c < used.size(); c++)
+        prefix[c + 1] = Convolve(prefix[c], used[c]->counts);
+
+    for (size_t c = used.size(); c > 0; c--)
+        suffix[c - 1] = Convolve(suffix[c], used[c - 1]->counts);
+
+    // Ways to place the rest of the mines off the frontier, relative to the most likely case
+    int minesLeft = solver.UnknownMines();
+    int others = solver.UnknownTiles() - frontier;
+    std::vector<double> ways(frontier + 1, 0.0);
+    double largest = -HUGE_VAL;
+
+    for (int j = 0; j <= frontier; j++)
+    {
+        int rest = minesLeft - j;
+
+        if (rest < 0 || rest > others)
+        {
+            ways[j] = -HUGE_VAL;
+            continue;
+        }
+
+        ways[j] = std::lgamma(others + 1.0) - std::lgamma(rest + 1.0) - std::lgamma(others - rest + 1.0);
+        largest = std::max(largest, ways[j]);
+    }
+
+    if (largest == -HUGE_VAL)
+        return false;
+
+    for (double &value : ways)
+        value = value == -HUGE_VAL ? 0.0 : std::exp(value - largest);
+
+    const std::vector<double> &all = prefix[used.size()];
+    double total = 0.0, interiorMines = 0.0;
+
+    for (size_t j = 0; j < all.size(); j++)
+    {
+        total += all[j] * ways[j];
+        interiorMines += all[j] * ways[j] * (minesLeft - static_cast<int>(j));
+    }
+
+    if (total <= 0.0)
+        return false;
+
+    interior = others ? static_cast<float>(interiorMines / total / others) : 0.0f;
+
+    for (size_t c = 0; c < used.size(); c++)
+    {
+        const component_t &component = *used[c];
+        std::vector<double> rest = Convolve(prefix[c], suffix[c + 1]);
+        size_t tiles = component.tiles.size();
+
+        // Weight of every mine count of this component given everything else
+        std::vector<double> weights(component.counts.size(), 0.0);
+        double componentTotal = 0.0;
+
+        for (size_t k = 0; k < weights.size(); k++)
+        {
+            for (size_t s = 0; s < rest.size() && k + s < ways.size(); s++)
+                weights[k] += rest[s] * ways[k + s];
+
+            componentTotal += component.counts[k] * weights[k];
+        }
+
+        for (size_t t = 0; t < tiles; t++)
+        {
+            double mined = 0.0;
+
+            for (size_t k = 0; k < weights.size(); k++)
+                mined += component.tileCounts[k * tiles + t] * weights[k];
+
+            probabilities[component.tiles[t]] = static_cast<float>(mined / componentTotal);
+        }
+    }
+
+    for (int i = 0; i < board.Size(); i++)
+    {
+        if (solver.Knowledge(i) == Solver::MINE)
+            probabilities[i] = 1.0f;
+        else if (solver.Knowledge(i) == Solver::UNKNOWN && parents[i] < 0)
+            probabilities[i] = interior;
+    }
+
+    // Components that are gone from the board won't come back
+    for (auto it = cache.begin(); it != cache.end();)
+    {
+        if (it->second.used)
+        {
+            it->second.used = false;
+            ++it;
+        }
+        else
+        {
+            it = cache.erase(it);
+        }
+    }
+
+    return true;
+}
+
+/*
+===================
+Probability::Find
+===================
+*/
+int Probability::Find(int tile)
+{
+    while (parents[tile] != tile)
+    {
+        parents[tile] = parents[parents[tile]];
+        tile = parents[tile];
+    }
+
+    return tile;
+}
+
+/*
+===================
+Probability::Enumerate
+
+Counts every valid placement of mines in a component.
+===================
+*/
+bool Probability::Enumerate(component_t &component, const std::vector<const constraint_t *> &numbers)
+{
+    int tiles = static_cast<int>(component.tiles.size());
+
+    // Reorders tiles breadth first through the numbers they share
+    std::vector<int> order;
+    std::vector<bool> visited(tiles, false);
+    std::vector<bool> numberVisited(numbers.size(), false);
+    order.reserve(tiles);
+
+    auto local = [&component](int tile)
+    {
+        return static_cast<int>(std::lower_bound(component.tiles.begin(), component.tiles.end(), tile) - component.tiles.begin());
+    };
+
+    visited[0] = true;
+    order.push_back(component.tiles[0]);
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        for (size_t n = 0; n < numbers.size(); n++)
+        {
+            const std::vector<int> &numberTiles = numbers[n]->tiles;
+
+            if (numberVisited[n] || std::find(numberTiles.begin(), numberTiles.end(), order[i]) == numberTiles.end())
+                continue;
+
+            numberVisited[n] = true;
+
+            for (int tile : numberTiles)
+            {
+                if (!visited[local(tile)])
+                {
+                    visited[local(tile)] = true;
+                    order.push_back(tile);
+                }
+            }
+        }
+    }
+
+    enumeration_t state;
+    state.tiles = tiles;
+    state.maxNodes = maxNodes;
+    state.cancel = cancel;
+    state.tileNumbers.resize(tiles);
+    state.need.resize(numbers.size());
+    state.mined.assign(numbers.size(), 0);
+    state.left.resize(numbers.size());
+    state.bits.assign((tiles + 63) / 64, 0);
+    state.counts = &component.counts;
+    state.tileCounts = &component.tileCounts;
+
+    for (size_t n = 0; n < numbers.size(); n++)
+    {
+        state.need[n] = numbers[n]->mines;
+        state.left[n] = static_cast<int>(numbers[n]->tiles.size());
+
+        for (int tile : numbers[n]->tiles)
+            state.tileNumbers[std::find(order.begin(), order.end(), tile) - order.begin()].push_back(static_cast<int>(n));
+    }
+
+    component.tiles = std::move(order);
+    component.counts.assign(tiles + 1, 0.0);
+    component.tileCounts.assign(static_cast<size_t>(tiles + 1) * tiles, 0.0);
+
+    return state.Step(0);
+}
@@ -0,0 +1,106 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Solver.h"
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Backtracking steps a single component may take before it's considered too big to count exactly
+#define PROBABILITY_MAX_NODES       4000000
+
+/*
+===========================================================
+
+    Probability
+
+    The exact chance of every closed tile being a mine.
+
+    Unknown tiles next to numbers form the frontier, which splits into
+    components that don't share any number. Every component is counted
+    on its own by backtracking over a bitset of mines, keeping the number
+    of solutions for each mine count. Components are then combined, with
+    each total weighted by the ways to place the remaining mines in the
+    tiles no number touches.
+
+    Counting can be cancelled from another thread, in which case
+    Compute() fails and nothing half-counted is kept.
+
+    A component's counts only depend on its tiles and numbers, so they
+    are kept between moves and most of the frontier isn't counted again.
+
+===========================================================
+*/
+class Probability
+{
+public:
+
+    // The solver has to be up to date with the board
+    bool                Compute(const Board &board, const Solver &solver);
+
+    // 0 for open tiles and tiles proven safe, 1 for proven mines
+    float               At(int index) const { return probabilities[index]; }
+    const std::vector<float> &Probabilities() const { return probabilities; }
+
+    // The chance for a tile no number touches
+    float               InteriorProbability() const { return interior; }
+
+    int                 Components() const { return components; }
+    bool                IsTooBig() const { return tooBig; }  // Why the last Compute() failed, if it wasn't a contradiction
+    int                 CacheHits() const { return cacheHits; }
+
+    int                 maxNodes = PROBABILITY_MAX_NODES;
+    const std::atomic<bool> *cancel = nullptr;  // Gives up on counting as soon as it's set
+
+private:
+
+    struct component_t
+    {
+        std::vector<int> key;
+        std::vector<int> tiles;
+        std::vector<double> counts;     // Solutions for every number of mines
+        std::vector<double> tileCounts; // Solutions with the tile mined, by the number of mines then by the tile
+        bool            used = false;
+    };
+
+    struct constraint_t
+    {
+        std::vector<int> tiles;
+        int             mines;
+    };
+
+    int                 Find(int tile);
+    bool                Enumerate(component_t &component, const std::vector<const constraint_t *> &numbers);
+
+    std::vector<float>  probabilities;
+    float               interior = 0.0f;
+    int                 components = 0;
+    int                 cacheHits = 0;
+    bool                tooBig = false;
+
+    std::vector<int>    parents;
+    std::vector<constraint_t> constraints;
+    unsigned            generation = 0;
+    unsigned            reverts = 0;
+    std::unordered_map<uint64_t, component_t> cache;
+};
@@ -0,0 +1,88 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Random.h"
+
+/*
+===================
+SplitMix
+===================
+*/
+static uint64_t SplitMix(uint64_t &x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
+
+/*
+===================
+Random::Random
+===================
+*/
+Random::Random(uint64_t seed, uint64_t stream)
+{
+    uint64_t streamState = stream;
+    uint64_t x = seed ^ SplitMix(streamState);
+
+    for (uint64_t &word : state)
+        word = SplitMix(x);
+}
+
+/*
+===================
+Random::Float
+
+Returns a number in the [0, 1) range.
+===================
+*/
+float Random::Float()
+{
+    return static_cast<float>(Next() >> 40) / static_cast<float>(1ull << 24);
+}
+
+/*
+===================
+Random::Jump
+
+Advances by 2^128 numbers at once.
+===================
+*/
+void Random::Jump()
+{
+    static const uint64_t polynomial[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+    uint64_t jumped[4] = {};
+
+    for (uint64_t word : polynomial)
+    {
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (word & (1ull << bit))
+                for (int i = 0; i < 4; i++)
+                    jumped[i] ^= state[i];
+
+            Next();
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+        state[i] = jumped[i];
+}
@@ -0,0 +1,112 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+/*
+===========================================================
+
+    Random
+
+    xoshiro256**, seeded through splitmix64. It only uses fixed-width
+    integer arithmetic, so the same seed gives the same numbers, and
+    the same boards, on every compiler and platform.
+
+    Generators created with the same seed but different streams start
+    at unrelated points of a 2^256 period and don't overlap in practice.
+    Workers that must never overlap take one generator and Jump() it
+    once more for every worker instead, each jump skips 2^128 numbers.
+
+===========================================================
+*/
+class Random
+{
+public:
+
+                        Random(uint64_t seed = 0, uint64_t stream = 0);
+
+    uint64_t            Next();
+    int                 Int(int min, int max);
+    float               Float();
+
+    void                Jump();
+
+    // Makes the class usable with GenerateMines
+    int                 operator()(int min, int max) { return Int(min, max); }
+
+private:
+
+    uint64_t            state[4];
+};
+
+/*
+===================
+Rotate
+===================
+*/
+inline uint64_t Rotate(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/*
+===================
+Random::Next
+===================
+*/
+inline uint64_t Random::Next()
+{
+    uint64_t result = Rotate(state[1] * 5, 7) * 9;
+    uint64_t shifted = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3] = Rotate(state[3], 45);
+
+    return result;
+}
+
+/*
+===================
+Random::Int
+
+Returns an integer in the inclusive [min, max] range.
+Lemire's multiply and shift, with rejection so every number is equally likely.
+===================
+*/
+inline int Random::Int(int min, int max)
+{
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+    uint64_t product = (Next() >> 32) * range;
+
+    if (static_cast<uint32_t>(product) < range)
+    {
+        uint32_t threshold = static_cast<uint32_t>((0x100000000ull - range) % range);
+
+        while (static_cast<uint32_t>(product) < threshold)
+            product = (Next() >> 32) * range;
+    }
+
+    return static_cast<int>(min + static_cast<int64_t>(product >> 32));
+}
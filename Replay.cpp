@@ -0,0 +1,960 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Replay.h"
+#include "Generator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+
+/*
+===================
+PutVarint
+===================
+*/
+static void PutVarint(std::vector<uint8_t> &bytes, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+/*
+===================
+GetVarint
+===================
+*/
+static bool GetVarint(const std::vector<uint8_t> &bytes, size_t &offset, uint64_t &value)
+{
+    value = 0;
+
+    for (int shift = 0; shift < 64 && offset < bytes.size(); shift += 7)
+    {
+        uint8_t byte = bytes[offset++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+/*
+===================
+Replay::MarkType
+===================
+*/
+Replay::type_t Replay::MarkType(Tile::state_t state, bool marksEnabled)
+{
+    if (state == Tile::CLOSED)
+        return FLAG;
+
+    if (state == Tile::FLAGGED && marksEnabled)
+        return QUESTION;
+
+    return CLEAR;
+}
+
+/*
+===================
+Replay::Clear
+
+Keeps the buffers, so recording the next game doesn't allocate.
+===================
+*/
+void Replay::Clear()
+{
+    header = header_t();
+    mined.clear();
+    stream.clear();
+    keyframes.clear();
+    keyframeIndex.clear();
+    lastMilliseconds = 0;
+    lastTile = 0;
+}
+
+/*
+===================
+Replay::Append
+===================
+*/
+void Replay::Append(const action_t &action)
+{
+    int width = static_cast<int>(header.width);
+    int dx = action.x - lastTile % width;
+    int dy = action.y - lastTile / width;
+    uint32_t elapsed = action.milliseconds >= lastMilliseconds ? action.milliseconds - lastMilliseconds : 0;
+
+    PutVarint(stream, (static_cast<uint64_t>(elapsed) << 3) | action.type);
+
+    // Tiles near the previous one fit a single byte, others are stored as they are
+    if (dx >= -REPLAY_NEAR && dx <= REPLAY_NEAR && dy >= -REPLAY_NEAR && dy <= REPLAY_NEAR)
+        PutVarint(stream, static_cast<uint64_t>(((dx + REPLAY_NEAR) * (2 * REPLAY_NEAR + 1) + dy + REPLAY_NEAR) << 1));
+    else
+        PutVarint(stream, (static_cast<uint64_t>(action.y * width + action.x) << 1) | 1);
+
+    lastMilliseconds += elapsed;
+    lastTile = action.y * width + action.x;
+    header.milliseconds = lastMilliseconds;
+    header.actions++;
+    header.streamBytes = static_cast<uint32_t>(stream.size());
+}
+
+/*
+===================
+Replay::Next
+
+Decodes the action at the cursor and moves past it. False at the end or if the actions are damaged.
+===================
+*/
+bool Replay::Next(cursor_t &cursor, action_t &action) const
+{
+    uint64_t timeAndType, place;
+
+    if (cursor.action >= header.actions || !header.width ||
+        !GetVarint(stream, cursor.offset, timeAndType) || !GetVarint(stream, cursor.offset, place))
+        return false;
+
+    int64_t x, y;
+
+    if (place & 1)
+    {
+        x = static_cast<int64_t>((place >> 1) % header.width);
+        y = static_cast<int64_t>((place >> 1) / header.width);
+    }
+    else
+    {
+        x = cursor.tile % header.width + static_cast<int64_t>(place >> 1) / (2 * REPLAY_NEAR + 1) - REPLAY_NEAR;
+        y = cursor.tile / header.width + static_cast<int64_t>(place >> 1) % (2 * REPLAY_NEAR + 1) - REPLAY_NEAR;
+    }
+
+    if ((timeAndType & 7) > RESTART || x < 0 || y < 0 || x >= header.width || y >= header.height)
+        return false;
+
+    cursor.milliseconds += static_cast<uint32_t>(timeAndType >> 3);
+    cursor.tile = static_cast<int>(y * header.width + x);
+    cursor.action++;
+
+    action.milliseconds = cursor.milliseconds;
+    action.type = static_cast<type_t>(timeAndType & 7);
+    action.x = static_cast<int>(x);
+    action.y = static_cast<int>(y);
+    return true;
+}
+
+/*
+===================
+Replay::StoreMines
+===================
+*/
+void Replay::StoreMines(const Board &board)
+{
+    mined.assign((board.Size() + 7) / 8, 0);
+
+    for (int i = 0; i < board.Size(); i++)
+        if (board[i].type == Tile::MINED)
+            mined[i >> 3] |= 1 << (i & 7);
+}
+
+/*
+===================
+Replay::Write
+
+Appends the whole replay, as it's saved, to the bytes.
+===================
+*/
+void Replay::Write(std::vector<uint8_t> &bytes) const
+{
+    const uint8_t *start = reinterpret_cast<const uint8_t *>(&header);
+    bytes.insert(bytes.end(), start, start + sizeof(header));
+
+    // Games given up before the first click have neither a seed nor mines
+    if (!header.seed)
+    {
+        size_t size = (static_cast<size_t>(header.width) * header.height + 7) / 8;
+        bytes.insert(bytes.end(), mined.begin(), mined.begin() + std::min(size, mined.size()));
+        bytes.resize(bytes.size() + size - std::min(size, mined.size()), 0);
+    }
+
+    bytes.insert(bytes.end(), stream.begin(), stream.end());
+    bytes.insert(bytes.end(), keyframes.begin(), keyframes.end());
+}
+
+/*
+===================
+Replay::Read
+
+Reads a replay written at the offset and moves past it.
+===================
+*/
+bool Replay::Read(const std::vector<uint8_t> &bytes, size_t &offset)
+{
+    Clear();
+
+    auto take = [&](void *data, size_t size)
+    {
+        if (size > bytes.size() - offset)
+            return false;
+
+        if (size)
+            memcpy(data, bytes.data() + offset, size);
+
+        offset += size;
+        return true;
+    };
+
+    bool read = offset <= bytes.size() && take(&header, sizeof(header)) && header.magic == REPLAY_MAGIC &&
+                header.version == REPLAY_VERSION && header.width && header.height &&
+                header.width <= REPLAY_MAX_SIZE && header.height <= REPLAY_MAX_SIZE && header.mines < header.width * header.height &&
+                header.streamBytes <= bytes.size() && header.keyframeBytes <= bytes.size();
+
+    // Checked before anything is allocated for the mines
+    if (read && !header.seed)
+    {
+        size_t size = (header.width * header.height + 7) / 8;
+        read = size <= bytes.size() - offset;
+
+        if (read)
+        {
+            mined.resize(size);
+            read = take(mined.data(), mined.size());
+        }
+    }
+
+    if (read)
+    {
+        stream.resize(header.streamBytes);
+        keyframes.resize(header.keyframeBytes);
+        read = take(stream.data(), stream.size()) && take(keyframes.data(), keyframes.size());
+    }
+
+    if (!read)
+    {
+        Clear();
+        return false;
+    }
+
+    // The game can be played without them, only seeking is slower
+    if (!IndexKeyframes())
+    {
+        keyframes.clear();
+        keyframeIndex.clear();
+        header.keyframeBytes = 0;
+    }
+
+    return true;
+}
+
+/*
+===================
+Replay::Save
+===================
+*/
+bool Replay::Save(const char *path) const
+{
+    FILE *file = std::fopen(path, "wb");
+
+    if (!file)
+        return false;
+
+    std::vector<uint8_t> bytes;
+    Write(bytes);
+
+    bool saved = std::fwrite(bytes.data(), bytes.size(), 1, file) == 1;
+    return std::fclose(file) == 0 && saved;
+}
+
+/*
+===================
+Replay::Load
+===================
+*/
+bool Replay::Load(const char *path)
+{
+    Clear();
+
+    FILE *file = std::fopen(path, "rb");
+
+    if (!file)
+        return false;
+
+    std::vector<uint8_t> bytes;
+    uint8_t block[65536];
+    size_t size;
+
+    while ((size = std::fread(block, 1, sizeof(block), file)) > 0)
+        bytes.insert(bytes.end(), block, block + size);
+
+    std::fclose(file);
+
+    size_t offset = 0;
+    return Read(bytes, offset) && offset == bytes.size();
+}
+
+/*
+===================
+Replay::SeekEnd
+
+Gets ready to append to a replay that was read.
+===================
+*/
+void Replay::SeekEnd()
+{
+    cursor_t cursor;
+    action_t action;
+
+    while (Next(cursor, action));
+
+    lastMilliseconds = cursor.milliseconds;
+    lastTile = cursor.tile;
+}
+
+/*
+===================
+Replay::BuildKeyframes
+===================
+*/
+void Replay::BuildKeyframes()
+{
+    keyframes.clear();
+    keyframeIndex.clear();
+    header.keyframeBytes = 0;
+
+    Board board;
+    ReplayPlayer player;
+    std::vector<Tile::state_t> previous;
+    std::vector<uint8_t> runs;
+    size_t work = 0, changes = 0, count = 0;
+
+    player.Start(*this, board);
+
+    while (player.Step(board))
+    {
+        work += 1 + board.Changes().size() - changes;
+        changes = board.Changes().size();
+
+        // Positions after the end are never sought, the last action gets there
+        if (work < REPLAY_KEYFRAME_WORK || !board.IsGenerated() || board.State() != Board::PLAYING)
+            continue;
+
+        bool full = !(count++ % REPLAY_FULL_KEYFRAMES);
+        previous.resize(board.Size(), Tile::CLOSED);
+        runs.clear();
+
+        // Runs of tiles with the same new state in the low bits, or unchanged
+        for (int i = 0; i < board.Size();)
+        {
+            auto code = [&](int tile) { return full || board[tile].state != previous[tile] ? board[tile].state : REPLAY_UNCHANGED; };
+            int run = 1;
+
+            while (i + run < board.Size() && code(i + run) == code(i))
+                run++;
+
+            PutVarint(runs, (static_cast<uint64_t>(run - 1) << 3) | code(i));
+
+            for (int t = i; t < i + run; t++)
+                previous[t] = board[t].state;
+
+            i += run;
+        }
+
+        const cursor_t &cursor = player.Cursor();
+        PutVarint(keyframes, cursor.action);
+        PutVarint(keyframes, cursor.offset);
+        PutVarint(keyframes, cursor.milliseconds);
+        PutVarint(keyframes, cursor.tile);
+        PutVarint(keyframes, player.Action().type);
+        PutVarint(keyframes, player.leftClicks);
+        PutVarint(keyframes, player.rightClicks);
+        PutVarint(keyframes, player.chordClicks);
+        PutVarint(keyframes, full);
+        PutVarint(keyframes, runs.size());
+        keyframes.insert(keyframes.end(), runs.begin(), runs.end());
+        work = 0;
+    }
+
+    header.keyframeBytes = static_cast<uint32_t>(keyframes.size());
+    IndexKeyframes();
+}
+
+/*
+===================
+Replay::IndexKeyframes
+
+Where every keyframe is, so seeking only decodes the ones it needs.
+===================
+*/
+bool Replay::IndexKeyframes()
+{
+    keyframeIndex.clear();
+
+    size_t offset = 0;
+
+    while (offset < keyframes.size())
+    {
+        uint64_t values[10];
+
+        for (uint64_t &value : values)
+            if (!GetVarint(keyframes, offset, value))
+                return false;
+
+        keyframe_t keyframe;
+        keyframe.cursor.action = static_cast<uint32_t>(values[0]);
+        keyframe.cursor.offset = static_cast<size_t>(values[1]);
+        keyframe.cursor.milliseconds = static_cast<uint32_t>(values[2]);
+        keyframe.cursor.tile = static_cast<int>(values[3]);
+        keyframe.type = static_cast<type_t>(values[4]);
+        keyframe.leftClicks = static_cast<int>(values[5]);
+        keyframe.rightClicks = static_cast<int>(values[6]);
+        keyframe.chordClicks = static_cast<int>(values[7]);
+        keyframe.full = values[8] != 0;
+        keyframe.offset = offset;
+        keyframe.size = static_cast<size_t>(values[9]);
+
+        // In order, inside the actions and the board, and starting with a full one
+        const keyframe_t *previous = keyframeIndex.empty() ? nullptr : &keyframeIndex.back();
+
+        if (values[0] > header.actions || values[1] > stream.size() || values[3] >= static_cast<uint64_t>(header.width) * header.height ||
+            values[4] > RESTART || keyframe.size > keyframes.size() - offset || (!previous && !keyframe.full) ||
+            (previous && (keyframe.cursor.action <= previous->cursor.action || keyframe.cursor.milliseconds < previous->cursor.milliseconds)))
+            return false;
+
+        keyframeIndex.push_back(keyframe);
+        offset += keyframe.size;
+    }
+
+    return true;
+}
+
+/*
+===================
+Replay::LoadStates
+
+The last full keyframe up to this one, and the changes of every keyframe after it.
+===================
+*/
+bool Replay::LoadStates(size_t keyframe, std::vector<Tile::state_t> &states) const
+{
+    size_t size = static_cast<size_t>(header.width) * header.height;
+    size_t first = keyframe;
+
+    while (!keyframeIndex[first].full)
+        first--;
+
+    states.resize(size);
+
+    for (size_t k = first; k <= keyframe; k++)
+    {
+        size_t offset = keyframeIndex[k].offset, end = offset + keyframeIndex[k].size;
+
+        for (size_t i = 0; i < size;)
+        {
+            uint64_t run;
+
+            if (offset >= end || !GetVarint(keyframes, offset, run) || (run >> 3) >= size - i || (run & 7) > REPLAY_UNCHANGED ||
+                ((run & 7) == REPLAY_UNCHANGED && k == first))
+                return false;
+
+            if ((run & 7) != REPLAY_UNCHANGED)
+                std::fill_n(states.begin() + i, (run >> 3) + 1, static_cast<Tile::state_t>(run & 7));
+
+            i += (run >> 3) + 1;
+        }
+
+        if (offset != end)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+===================
+ReplayPlayer::Start
+===================
+*/
+void ReplayPlayer::Start(const Replay &replay, Board &board)
+{
+    this->replay = &replay;
+    cursor = Replay::cursor_t();
+    action = Replay::action_t();
+    applied = 0;
+    leftClicks = rightClicks = chordClicks = 0;
+    abandoned = false;
+    done = false;
+    error = NONE;
+
+    board.Reset(replay.header.width, replay.header.height, replay.header.mines);
+    position = cursor;
+    hasNext = replay.Next(cursor, nextAction);
+}
+
+/*
+===================
+ReplayPlayer::Step
+===================
+*/
+bool ReplayPlayer::Step(Board &board)
+{
+    if (done)
+        return false;
+
+    if (!hasNext)
+    {
+        done = true;
+
+        // Everything the header promises has to be there, and nothing else
+        if (applied != replay->header.actions || cursor.offset != replay->stream.size())
+            return Fail(DAMAGED);
+
+        return false;
+    }
+
+    const Replay::action_t &next = nextAction;
+
+    if (board.State() != Board::PLAYING || abandoned)
+        return Fail(AFTER_END);
+
+    const Tile &tile = board.At(next.x, next.y);
+
+    if (next.type == Replay::OPEN)
+    {
+        if (!tile.CanOpen())
+            return Fail(WRONG_ACTION);
+
+        if (!board.IsGenerated() && !Generate(board, next.x, next.y))
+            return Fail(DAMAGED);
+
+        leftClicks++;
+        board.Open(next.x, next.y);
+    }
+    else if (next.type == Replay::CHORD)
+    {
+        if (tile.state != Tile::OPEN || !tile.nearestMines)
+            return Fail(WRONG_ACTION);
+
+        chordClicks++;
+        board.Chord(next.x, next.y);
+    }
+    else if (next.type == Replay::RESTART)
+    {
+        abandoned = true;
+    }
+    else
+    {
+        // Question marks only come from flags with marks enabled
+        bool marksEnabled = next.type == Replay::QUESTION;
+
+        if (tile.state == Tile::OPEN || Replay::MarkType(tile.state, marksEnabled) != next.type)
+            return Fail(WRONG_ACTION);
+
+        rightClicks++;
+        board.ToggleFlag(next.x, next.y, marksEnabled);
+    }
+
+    action = next;
+    applied++;
+    position = cursor;
+    hasNext = replay->Next(cursor, nextAction);
+    return true;
+}
+
+/*
+===================
+ReplayPlayer::Finish
+===================
+*/
+ReplayPlayer::error_t ReplayPlayer::Finish(Board &board)
+{
+    while (Step(board));
+
+    if (error != NONE)
+        return error;
+
+    const Replay::header_t &header = replay->header;
+    bool finished = header.result == Replay::WON ? board.State() == Board::WON :
+                    header.result == Replay::LOST ? board.State() == Board::LOST : abandoned;
+
+    if (!finished)
+        return error = WRONG_RESULT;
+
+    if (action.milliseconds != header.milliseconds)
+        return error = WRONG_TIME;
+
+    return NONE;
+}
+
+/*
+===================
+ReplayPlayer::Seek
+===================
+*/
+void ReplayPlayer::Seek(Board &board, uint32_t milliseconds)
+{
+    const std::vector<Replay::keyframe_t> &keyframes = replay->Keyframes();
+    auto after = std::upper_bound(keyframes.begin(), keyframes.end(), milliseconds,
+                                  [](uint32_t time, const Replay::keyframe_t &keyframe) { return time < keyframe.cursor.milliseconds; });
+    const Replay::keyframe_t *keyframe = after == keyframes.begin() ? nullptr : &*(after - 1);
+    bool passed = applied && action.milliseconds > milliseconds;
+
+    // Forward from where the player is, unless a keyframe is closer
+    if ((passed || (keyframe && keyframe->cursor.action > applied)) && !(keyframe && Restore(board, keyframe - keyframes.data())))
+        Rewind(board);
+
+    while (hasNext && !done && nextAction.milliseconds <= milliseconds)
+        Step(board);
+}
+
+/*
+===================
+ReplayPlayer::Rewind
+
+Back to the start, keeping the mines. Generating a big board again would take longer than the rest of seeking.
+===================
+*/
+void ReplayPlayer::Rewind(Board &board)
+{
+    if (!board.IsGenerated())
+    {
+        Start(*replay, board);
+        return;
+    }
+
+    states.assign(board.Size(), Tile::CLOSED);
+    board.SetStates(states);
+
+    cursor = position = Replay::cursor_t();
+    action = Replay::action_t();
+    applied = 0;
+    leftClicks = rightClicks = chordClicks = 0;
+    abandoned = false;
+    done = false;
+    error = NONE;
+    hasNext = replay->Next(cursor, nextAction);
+}
+
+/*
+===================
+ReplayPlayer::Restore
+
+Keyframes only have the tile states, the mines come from the board of the same game.
+===================
+*/
+bool ReplayPlayer::Restore(Board &board, size_t index)
+{
+    const Replay::keyframe_t &keyframe = replay->Keyframes()[index];
+
+    if (!board.IsGenerated())
+    {
+        Start(*replay, board);
+
+        while (!board.IsGenerated() && Step(board));
+    }
+
+    if (!board.IsGenerated() || !replay->LoadStates(index, states))
+        return false;
+
+    board.SetStates(states);
+    cursor = position = keyframe.cursor;
+    applied = cursor.action;
+    leftClicks = keyframe.leftClicks;
+    rightClicks = keyframe.rightClicks;
+    chordClicks = keyframe.chordClicks;
+    action = { cursor.milliseconds, keyframe.type, cursor.tile % board.Width(), cursor.tile / board.Width() };
+    abandoned = false;
+    done = false;
+    error = NONE;
+    hasNext = replay->Next(cursor, nextAction);
+    return true;
+}
+
+/*
+===================
+ReplayPlayer::NextMilliseconds
+===================
+*/
+uint32_t ReplayPlayer::NextMilliseconds() const
+{
+    return hasNext ? nextAction.milliseconds : action.milliseconds;
+}
+
+/*
+===================
+ReplayPlayer::ErrorName
+===================
+*/
+const char *ReplayPlayer::ErrorName(error_t error)
+{
+    static const char *names[] = { "valid", "damaged", "impossible action", "actions after the end", "wrong result", "wrong time" };
+    return names[error];
+}
+
+/*
+===================
+ReplayPlayer::Fail
+===================
+*/
+bool ReplayPlayer::Fail(error_t error)
+{
+    this->error = error;
+    done = true;
+    return false;
+}
+
+/*
+===================
+ReplayPlayer::Generate
+
+The same board the game had, from its seed and the first click or from the stored mines.
+===================
+*/
+bool ReplayPlayer::Generate(Board &board, int x, int y) const
+{
+    if (replay->header.seed)
+    {
+        Generator::FromSeed(board, replay->header.seed, x, y);
+        return true;
+    }
+
+    if (!replay->HasMines())
+        return false;
+
+    std::vector<int> mined;
+
+    for (int i = 0; i < board.Size(); i++)
+        if (replay->IsMined(i))
+            mined.push_back(i);
+
+    board.PlaceMines(mined);
+    return board.Mines() == static_cast<int>(replay->header.mines);
+}
+
+/*
+===================
+ReplayRecorder::Start
+
+Abandons whatever was being recorded.
+===================
+*/
+void ReplayRecorder::Start(int width, int height, int mines, int difficulty)
+{
+    replay.Clear();
+    replay.stream.reserve(REPLAY_BUFFER_BYTES);
+
+    replay.header.width = width;
+    replay.header.height = height;
+    replay.header.mines = mines;
+    replay.header.difficulty = static_cast<uint8_t>(difficulty);
+    recording = true;
+}
+
+/*
+===================
+ReplayRecorder::Resume
+===================
+*/
+void ReplayRecorder::Resume(const Replay &recorded)
+{
+    Start(recorded.header.width, recorded.header.height, recorded.header.mines, recorded.header.difficulty);
+
+    replay.header = recorded.header;
+    replay.mined = recorded.mined;
+    replay.stream.assign(recorded.stream.begin(), recorded.stream.end());
+    replay.SeekEnd();
+}
+
+/*
+===================
+ReplayRecorder::Record
+===================
+*/
+void ReplayRecorder::Record(Replay::type_t type, int x, int y, uint32_t milliseconds)
+{
+    if (recording)
+        replay.Append({ milliseconds, type, x, y });
+}
+
+/*
+===================
+ReplayRecorder::SetBoard
+===================
+*/
+void ReplayRecorder::SetBoard(const Board &board, uint64_t seed)
+{
+    if (!recording)
+        return;
+
+    replay.header.seed = seed;
+
+    if (!seed)
+        replay.StoreMines(board);
+    else
+        replay.mined.clear();
+}
+
+/*
+===================
+ReplayRecorder::Finish
+===================
+*/
+void ReplayRecorder::Finish(Replay::result_t result)
+{
+    if (!recording)
+        return;
+
+    recording = false;
+
+    if (!replay.header.actions || directory.empty())
+        return;
+
+    std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+    std::time_t date = std::chrono::system_clock::to_time_t(now);
+    int thousandths = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000);
+
+    replay.header.result = static_cast<uint8_t>(result);
+    replay.header.date = static_cast<int64_t>(date);
+
+    char name[64] = "";
+    std::tm local = {};
+#ifdef _WIN32
+    localtime_s(&local, &date);
+#else
+    localtime_r(&date, &local);
+#endif
+    size_t length = std::strftime(name, sizeof(name), "%Y%m%d-%H%M%S", &local);
+    length += std::snprintf(name + length, sizeof(name) - length, "-%03d", thousandths);
+
+    // Bots can finish several games within a millisecond
+    if (lastName == name)
+    {
+        std::snprintf(name + length, sizeof(name) - length, "-%d.mfr", ++sameName);
+    }
+    else
+    {
+        lastName = name;
+        sameName = 0;
+        std::snprintf(name + length, sizeof(name) - length, ".mfr");
+    }
+
+    // The last game stays around and the writer shares it, nothing is copied here
+    last = std::make_shared<const Replay>(std::move(replay));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({ directory + "/" + name, last });
+
+        if (!writer.joinable())
+            writer = std::thread(&ReplayRecorder::Write, this);
+    }
+
+    wake.notify_one();
+    replay = Replay();
+}
+
+/*
+===================
+ReplayRecorder::Stop
+===================
+*/
+void ReplayRecorder::Stop()
+{
+    if (!writer.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+
+    wake.notify_one();
+    writer.join();
+    stop = false;
+}
+
+/*
+===================
+ReplayRecorder::Write
+
+The writer thread, started with the first finished replay. Keyframes are built on a copy, the replay itself may be watched meanwhile.
+===================
+*/
+void ReplayRecorder::Write()
+{
+    std::vector<job_t> batch;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stop || !jobs.empty(); });
+
+            if (jobs.empty())
+                return;
+
+            batch.swap(jobs);
+        }
+
+        for (job_t &job : batch)
+        {
+            Replay saved = *job.replay;
+            saved.BuildKeyframes();
+            saved.Save(job.path.c_str());
+        }
+
+        Prune(directory);
+        batch.clear();
+    }
+}
+
+/*
+===================
+ReplayRecorder::Prune
+
+Removes the oldest replays beyond REPLAY_KEEP_FILES. Names start with the time the game ended, so they sort oldest first.
+===================
+*/
+void ReplayRecorder::Prune(const std::string &directory)
+{
+    std::error_code error;
+    std::vector<std::filesystem::path> files;
+
+    // Nothing here may throw, it runs on the writer thread
+    for (std::filesystem::directory_iterator i(directory, error), end; !error && i != end; i.increment(error))
+    {
+        if (i->is_regular_file(error) && i->path().extension() == ".mfr")
+            files.push_back(i->path());
+    }
+
+    if (files.size() <= REPLAY_KEEP_FILES)
+        return;
+
+    std::sort(files.begin(), files.end());
+
+    for (size_t i = 0; i < files.size() - REPLAY_KEEP_FILES; i++)
+        std::filesystem::remove(files[i], error);
+}
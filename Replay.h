@@ -0,0 +1,322 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Board.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define REPLAY_MAGIC                0x5052464D // "MFRP"
+#define REPLAY_VERSION              1
+#define REPLAY_BUFFER_BYTES         16384   // Preallocated for the actions of a game, only very long games need more
+#define REPLAY_KEEP_FILES           1000    // Replays kept in the directory, the oldest go first
+#define REPLAY_NEAR                 3       // Tiles this close to the previous action take a single byte
+#define REPLAY_KEYFRAME_WORK        16384   // Actions and tile changes between keyframes, the most that seeking replays
+#define REPLAY_FULL_KEYFRAMES       64      // Every this many keyframes has all tiles, the others only what changed
+#define REPLAY_UNCHANGED            4       // Run of tiles a keyframe leaves as they were
+#define REPLAY_MAX_SIZE             4096    // Widest and tallest board a replay is read for, far more than the tools need
+
+/*
+===========================================================
+
+    Replay
+
+    Everything that happened in a game, small enough to keep every
+    game and to share the best ones.
+
+    The board comes from the seed and the first click, which is always
+    the first action. Boards that can't be made from a seed, like the
+    no-guess ones, keep a bitmap of their mines instead.
+
+    Every action is two varints: the milliseconds since the previous
+    action shifted left by 3 with the type in the low bits, then the
+    tile. Players mostly click close to their last click, so tiles in
+    the square of REPLAY_NEAR around the previous one are stored as
+    that offset in a single byte, others by their index. Most actions
+    take 3 bytes, a typical Expert game a few hundred.
+
+    Long games on big boards also keep keyframes, the states of the
+    tiles every REPLAY_KEYFRAME_WORK actions and tile changes. They are
+    run length encoded, and most only have the tiles that changed since
+    the keyframe before, which are few and close together. Seeking
+    restores the nearest keyframe from the last full one before it and
+    only replays the actions after it. Games too short for a keyframe
+    have none.
+
+    Layout: header, mine bitmap if there is no seed, actions, keyframes.
+
+===========================================================
+*/
+class Replay
+{
+public:
+
+    enum type_t
+    {
+        OPEN,
+        FLAG,                               // Closed tile flagged
+        QUESTION,                           // Flag turned into a question mark
+        CLEAR,                              // Flag or question mark removed
+        CHORD,
+        RESTART                             // The game was abandoned, always the last action
+    };
+
+    enum result_t
+    {
+        WON,
+        LOST,
+        ABANDONED
+    };
+
+    struct header_t
+    {
+        uint32_t        magic = REPLAY_MAGIC;
+        uint32_t        version = REPLAY_VERSION;
+        uint32_t        width = 0;
+        uint32_t        height = 0;
+        uint32_t        mines = 0;
+        uint32_t        actions = 0;
+        uint64_t        seed = 0;           // 0 if the mines are stored
+        int64_t         date = 0;           // Seconds since the epoch, when the game ended
+        uint32_t        milliseconds = 0;   // Time of the last action, when the game ended
+        uint32_t        streamBytes = 0;
+        uint8_t         result = ABANDONED;
+        uint8_t         difficulty = 0;     // Like Settings::difficulty_t
+        uint16_t        reserved = 0;
+        uint32_t        keyframeBytes = 0;
+    };
+
+    struct action_t
+    {
+        uint32_t        milliseconds = 0;
+        type_t          type = OPEN;
+        int             x = 0;
+        int             y = 0;
+    };
+
+    // Position in the actions while decoding them one by one
+    struct cursor_t
+    {
+        size_t          offset = 0;
+        uint32_t        milliseconds = 0;
+        int             tile = 0;
+        uint32_t        action = 0;
+    };
+
+    struct keyframe_t
+    {
+        cursor_t        cursor;             // Right after the action the keyframe was taken at
+        type_t          type = OPEN;        // Of that action
+        int             leftClicks = 0;
+        int             rightClicks = 0;
+        int             chordClicks = 0;
+        bool            full = false;       // Has all tiles, not only the changed ones
+        size_t          offset = 0;         // Tile states in the keyframe bytes
+        size_t          size = 0;
+    };
+
+    // What toggling the flag of a tile does to it
+    static type_t       MarkType(Tile::state_t state, bool marksEnabled);
+
+    void                Clear();
+    void                Append(const action_t &action);
+    bool                Next(cursor_t &cursor, action_t &action) const;
+
+    void                Write(std::vector<uint8_t> &bytes) const;
+    bool                Read(const std::vector<uint8_t> &bytes, size_t &offset);
+    bool                Save(const char *path) const;
+    bool                Load(const char *path);
+
+    // Makes a replay that was read ready for more actions
+    void                SeekEnd();
+
+    // Plays the whole replay to take keyframes where it's worth it
+    void                BuildKeyframes();
+    const std::vector<keyframe_t> &Keyframes() const { return keyframeIndex; }
+    bool                LoadStates(size_t keyframe, std::vector<Tile::state_t> &states) const;
+
+    // The mine bitmap, for boards without a seed
+    void                StoreMines(const Board &board);
+    bool                HasMines() const { return !mined.empty(); }
+    bool                IsMined(int index) const { return (mined[index >> 3] >> (index & 7)) & 1; }
+
+    header_t            header;
+    std::vector<uint8_t> mined;
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> keyframes;
+
+private:
+
+    bool                IndexKeyframes();
+
+    std::vector<keyframe_t> keyframeIndex;
+    uint32_t            lastMilliseconds = 0;
+    int                 lastTile = 0;
+};
+
+/*
+===========================================================
+
+    ReplayPlayer
+
+    Plays a replay on a board with the same rules as the game, without
+    anything else of the game. Every action has to be one the game
+    would have taken, so a replay that plays to the end and finishes
+    the way it says is a game that was really played.
+
+    The board is the caller's, the game shows it while it's played,
+    the tools only check it.
+
+===========================================================
+*/
+class ReplayPlayer
+{
+public:
+
+    enum error_t
+    {
+        NONE,
+        DAMAGED,                            // The actions can't be decoded
+        WRONG_ACTION,                       // Not possible on the tile at that point of the game
+        AFTER_END,                          // Actions after the game was over
+        WRONG_RESULT,
+        WRONG_TIME
+    };
+
+    void                Start(const Replay &replay, Board &board);
+
+    // Applies the next action, false at the end or on an error
+    bool                Step(Board &board);
+
+    // Plays everything left and checks the result and the time
+    error_t             Finish(Board &board);
+
+    // Goes to the last action at or before the time, from the nearest keyframe unless the player is closer already
+    void                Seek(Board &board, uint32_t milliseconds);
+
+    // The time of the next action, to play it at the right moment
+    uint32_t            NextMilliseconds() const;
+
+    bool                IsDone() const { return done; }
+    error_t             Error() const { return error; }
+    uint32_t            Applied() const { return applied; }
+    const Replay::action_t &Action() const { return action; }   // The last one applied
+    const Replay::cursor_t &Cursor() const { return position; }
+
+    int                 leftClicks = 0;
+    int                 rightClicks = 0;
+    int                 chordClicks = 0;
+
+    static const char * ErrorName(error_t error);
+
+private:
+
+    bool                Fail(error_t error);
+    void                Rewind(Board &board);
+    bool                Restore(Board &board, size_t index);
+    bool                Generate(Board &board, int x, int y) const;
+
+    const Replay *      replay = nullptr;
+    Replay::cursor_t    cursor;
+    Replay::cursor_t    position;           // Of the last action applied, the cursor is already past the next one
+    Replay::action_t    action;
+    Replay::action_t    nextAction;         // Decoded one step ahead
+    bool                hasNext = false;
+    uint32_t            applied = 0;
+    bool                abandoned = false;
+    bool                done = true;
+    error_t             error = NONE;
+    std::vector<Tile::state_t> states;      // Of the keyframe being restored
+};
+
+/*
+===========================================================
+
+    ReplayRecorder
+
+    Records the game being played. Actions are appended to a buffer
+    that is allocated up front, and finished replays are written by a
+    thread of their own, so playing never waits for either. Only the
+    latest REPLAY_KEEP_FILES replays are kept.
+
+===========================================================
+*/
+class ReplayRecorder
+{
+public:
+
+                        ~ReplayRecorder() { Stop(); }
+
+    // Finished replays are saved here, named after the time they ended
+    void                SetDirectory(const char *path) { directory = path; }
+
+    void                Start(int width, int height, int mines, int difficulty);
+    void                Record(Replay::type_t type, int x, int y, uint32_t milliseconds);
+
+    // Once the mines are placed. A seed of 0 stores the mines instead.
+    void                SetBoard(const Board &board, uint64_t seed);
+
+    // Games without any action aren't saved
+    void                Finish(Replay::result_t result);
+    bool                IsRecording() const { return recording; }
+
+    // Drops the game being recorded, it isn't saved
+    void                Cancel() { recording = false; }
+
+    // Goes on with a game that was saved and resumed
+    void                Resume(const Replay &recorded);
+    const Replay &      Current() const { return replay; }
+
+    // Waits until everything has been written
+    void                Stop();
+
+    // The last replay that was finished, for watching it again
+    const Replay &      Last() const { return *last; }
+
+private:
+
+    struct job_t
+    {
+        std::string     path;
+        std::shared_ptr<const Replay> replay;
+    };
+
+    void                Write();
+    static void         Prune(const std::string &directory);
+
+    std::string         directory;
+    Replay              replay;
+    std::shared_ptr<const Replay> last = std::make_shared<const Replay>();  // Shared with the writer until it's saved
+    bool                recording = false;
+    std::string         lastName;
+    int                 sameName = 0;
+
+    std::mutex          mutex;
+    std::condition_variable wake;
+    std::vector<job_t>  jobs;
+    std::thread         writer;
+    bool                stop = false;
+};
@@ -0,0 +1,336 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Sampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+===================
+Sampler::Start
+===================
+*/
+void Sampler::Start(const Board &board, const Solver &solver)
+{
+    Cancel();
+
+    size = board.Size();
+    generation = board.Generation();
+    mines = solver.UnknownMines();
+    known.assign(size, 0.0f);
+    unknowns.clear();
+    need.clear();
+
+    std::vector<int> local(size, -1);
+
+    for (int i = 0; i < size; i++)
+    {
+        if (solver.Knowledge(i) == Solver::MINE)
+        {
+            known[i] = 1.0f;
+        }
+        else if (solver.Knowledge(i) == Solver::UNKNOWN)
+        {
+            known[i] = -1.0f;
+            local[i] = static_cast<int>(unknowns.size());
+            unknowns.push_back(i);
+        }
+    }
+
+    tileNumbers.assign(unknowns.size(), {});
+
+    // Open numbers next to unknown tiles
+    for (int i = 0; i < size; i++)
+    {
+        const Tile &tile = board[i];
+
+        if (tile.state != Tile::OPEN || tile.type == Tile::MINED)
+            continue;
+
+        int number = static_cast<int>(need.size());
+        int mined = tile.nearestMines;
+        bool used = false;
+
+        for (int y = board.Y(i) - 1; y <= board.Y(i) + 1; y++)
+        {
+            for (int x = board.X(i) - 1; x <= board.X(i) + 1; x++)
+            {
+                if (!board.IsInside(x, y))
+                    continue;
+
+                int neighbor = board.Index(x, y);
+
+                if (local[neighbor] >= 0)
+                {
+                    tileNumbers[local[neighbor]].push_back(number);
+                    used = true;
+                }
+                else if (solver.Knowledge(neighbor) == Solver::MINE)
+                {
+                    mined--;
+                }
+            }
+        }
+
+        if (used)
+            need.push_back(mined);
+    }
+
+    int threadCount = threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    accumulators.clear();
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        accumulators.push_back(std::make_unique<accumulator_t>());
+        accumulators.back()->sum.assign(unknowns.size(), 0.0);
+        accumulators.back()->sumSquares.assign(unknowns.size(), 0.0);
+    }
+
+    stop = false;
+    started = std::chrono::steady_clock::now();
+
+    // Nothing to sample
+    if (unknowns.empty() || mines < 0 || mines > static_cast<int>(unknowns.size()))
+        return;
+
+    for (int i = 0; i < threadCount; i++)
+        workers.emplace_back(&Sampler::Work, this, i);
+}
+
+/*
+===================
+Sampler::Cancel
+===================
+*/
+void Sampler::Cancel()
+{
+    stop = true;
+
+    for (std::thread &worker : workers)
+        worker.join();
+
+    workers.clear();
+}
+
+/*
+===================
+Sampler::Estimate
+
+Merges what all threads have sampled so far.
+===================
+*/
+void Sampler::Estimate(estimate_t &estimate) const
+{
+    std::vector<double> sum(unknowns.size(), 0.0), sumSquares(unknowns.size(), 0.0);
+    uint64_t batches = 0;
+
+    for (const std::unique_ptr<accumulator_t> &accumulator : accumulators)
+    {
+        std::lock_guard<std::mutex> lock(accumulator->mutex);
+
+        for (size_t t = 0; t < unknowns.size(); t++)
+        {
+            sum[t] += accumulator->sum[t];
+            sumSquares[t] += accumulator->sumSquares[t];
+        }
+
+        batches += accumulator->batches;
+    }
+
+    estimate.probabilities.assign(size, 0.0f);
+    estimate.errors.assign(size, 0.0f);
+    estimate.samples = batches * SAMPLER_BATCH;
+    estimate.generation = generation;
+    estimate.ready = batches >= 2;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    estimate.samplesPerSecond = seconds > 0.0 ? estimate.samples / seconds : 0.0;
+
+    for (int i = 0; i < size; i++)
+        if (known[i] >= 0.0f)
+            estimate.probabilities[i] = known[i];
+
+    if (!batches)
+        return;
+
+    for (size_t t = 0; t < unknowns.size(); t++)
+    {
+        double mean = sum[t] / batches;
+        double variance = batches > 1 ? std::max(0.0, (sumSquares[t] - batches * mean * mean) / (batches - 1)) : 0.0;
+
+        estimate.probabilities[unknowns[t]] = static_cast<float>(mean);
+        estimate.errors[unknowns[t]] = static_cast<float>(SAMPLER_Z * std::sqrt(variance / batches));
+    }
+}
+
+/*
+===================
+Sampler::Work
+
+A single chain, with a random stream of its own that never overlaps the others.
+===================
+*/
+void Sampler::Work(int index)
+{
+    Random random(seed);
+
+    for (int i = 0; i < index; i++)
+        random.Jump();
+
+    int count = static_cast<int>(unknowns.size());
+
+    std::vector<uint8_t> mined(count, 0);
+    std::vector<int> mineTiles, freeTiles;
+    std::vector<int> placed(need.size(), 0);
+
+    // Random layout with the right number of mines
+    for (int t = 0; t < count; t++)
+        freeTiles.push_back(t);
+
+    for (int i = 0; i < mines; i++)
+    {
+        int n = random.Int(i, count - 1);
+        std::swap(freeTiles[i], freeTiles[n]);
+    }
+
+    mineTiles.assign(freeTiles.begin(), freeTiles.begin() + mines);
+    freeTiles.erase(freeTiles.begin(), freeTiles.begin() + mines);
+
+    for (int tile : mineTiles)
+    {
+        mined[tile] = 1;
+
+        for (int number : tileNumbers[tile])
+            placed[number]++;
+    }
+
+    int violations = 0;
+
+    for (size_t n = 0; n < need.size(); n++)
+        violations += std::abs(placed[n] - need[n]);
+
+    // Moves a mine from a to b, returns the change in violations
+    auto move = [&](int a, int b, int sign)
+    {
+        int delta = 0;
+
+        for (int number : tileNumbers[a])
+        {
+            delta -= std::abs(placed[number] - need[number]);
+            placed[number] -= sign;
+            delta += std::abs(placed[number] - need[number]);
+        }
+
+        for (int number : tileNumbers[b])
+        {
+            delta -= std::abs(placed[number] - need[number]);
+            placed[number] += sign;
+            delta += std::abs(placed[number] - need[number]);
+        }
+
+        return delta;
+    };
+
+    auto swap = [&](int i, int j)
+    {
+        int a = mineTiles[i], b = freeTiles[j];
+
+        mineTiles[i] = b;
+        freeTiles[j] = a;
+        mined[a] = 0;
+        mined[b] = 1;
+    };
+
+    // The only layout there is, it's exact after two batches and sampling it again changes nothing
+    if (mineTiles.empty() || freeTiles.empty())
+    {
+        if (violations)
+            return;
+
+        accumulator_t &accumulator = *accumulators[index];
+        std::lock_guard<std::mutex> lock(accumulator.mutex);
+
+        for (int t = 0; t < count; t++)
+        {
+            accumulator.sum[t] = 2.0 * mined[t];
+            accumulator.sumSquares[t] = 2.0 * mined[t];
+        }
+
+        accumulator.batches = 2;
+        return;
+    }
+
+    std::vector<double> batch(count, 0.0);
+    int batchSamples = 0;
+    int sweep = count;
+    int burnIn = SAMPLER_BURN_IN;
+
+    // Chance to accept a move that breaks one more number
+    float worse[SAMPLER_MAX_DELTA + 1];
+
+    for (int delta = 0; delta <= SAMPLER_MAX_DELTA; delta++)
+        worse[delta] = std::exp(-delta / SAMPLER_TEMPERATURE);
+
+    while (!stop)
+    {
+        // A sweep of proposals between samples
+        for (int step = 0; step < sweep; step++)
+        {
+            int i = random.Int(0, static_cast<int>(mineTiles.size()) - 1);
+            int j = random.Int(0, static_cast<int>(freeTiles.size()) - 1);
+            int delta = move(mineTiles[i], freeTiles[j], 1);
+
+            if (delta <= 0 || (delta <= SAMPLER_MAX_DELTA && random.Float() < worse[delta]))
+            {
+                swap(i, j);
+                violations += delta;
+            }
+            else
+            {
+                move(mineTiles[i], freeTiles[j], -1);
+            }
+        }
+
+        // Every valid layout has the same weight in the chain, so the valid ones it visits are uniform
+        if (violations || burnIn-- > 0)
+            continue;
+
+        for (int t = 0; t < count; t++)
+            batch[t] += mined[t];
+
+        if (++batchSamples < SAMPLER_BATCH)
+            continue;
+
+        accumulator_t &accumulator = *accumulators[index];
+        std::lock_guard<std::mutex> lock(accumulator.mutex);
+
+        for (int t = 0; t < count; t++)
+        {
+            double mean = batch[t] / SAMPLER_BATCH;
+            accumulator.sum[t] += mean;
+            accumulator.sumSquares[t] += mean * mean;
+            batch[t] = 0.0;
+        }
+
+        accumulator.batches++;
+        batchSamples = 0;
+    }
+}
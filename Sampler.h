@@ -0,0 +1,113 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Solver.h"
+#include "Random.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define SAMPLER_BATCH               64      // Samples per batch mean
+#define SAMPLER_Z                   1.96f   // 95% confidence
+#define SAMPLER_TEMPERATURE         0.5f    // How freely chains may break numbers on the way to other layouts
+#define SAMPLER_MAX_DELTA           16
+#define SAMPLER_BURN_IN             64      // Sweeps before a chain is far enough from its random start
+
+/*
+===========================================================
+
+    Sampler
+
+    Estimates mine probabilities by sampling when the frontier is too
+    big to count exactly.
+
+    Every thread runs its own Markov chain over layouts with the right
+    mine count, where a mine and a free tile swap places. Layouts that
+    break numbers are allowed but penalized, so the chain can get from
+    one valid layout to another that no single swap reaches. Only valid
+    layouts are recorded, and since they all weigh the same in the
+    chain, they are sampled uniformly.
+
+    Confidence intervals come from batch means, so they stay honest even
+    though consecutive samples of a chain are correlated.
+
+    Start() copies what it needs from the board, so the board may change
+    while sampling. Starting again or Cancel() stops the previous run.
+
+===========================================================
+*/
+class Sampler
+{
+public:
+
+    struct estimate_t
+    {
+        std::vector<float> probabilities;
+        std::vector<float> errors;          // Half-width of the confidence interval
+        uint64_t        samples = 0;
+        double          samplesPerSecond = 0.0;
+        unsigned        generation = 0;     // Generation of the board that was sampled
+        bool            ready = false;      // There are enough batches for the intervals
+    };
+
+                        ~Sampler() { Cancel(); }
+
+    // The solver has to be up to date with the board
+    void                Start(const Board &board, const Solver &solver);
+    void                Cancel();
+    bool                IsRunning() const { return !workers.empty(); }
+
+    void                Estimate(estimate_t &estimate) const;
+
+    int                 threads = 0;        // All cores if 0
+    uint64_t            seed = 0;
+
+private:
+
+    struct accumulator_t
+    {
+        mutable std::mutex mutex;
+        std::vector<double> sum;            // Sum of batch means for every unknown tile
+        std::vector<double> sumSquares;
+        uint64_t        batches = 0;
+    };
+
+    void                Work(int index);
+
+    // Snapshot of the position
+    int                 size = 0;
+    unsigned            generation = 0;
+    int                 mines = 0;
+    std::vector<float>  known;              // Probability of tiles that aren't sampled, -1 for unknown tiles
+    std::vector<int>    unknowns;
+    std::vector<int>    need;               // Mines every number needs among the unknown tiles
+    std::vector<std::vector<int>> tileNumbers;
+
+    std::vector<std::unique_ptr<accumulator_t>> accumulators;
+    std::vector<std::thread> workers;
+    std::atomic<bool>   stop = false;
+    std::chrono::steady_clock::time_point started;
+};
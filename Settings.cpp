@@ -29,25 +29,42 @@ Settings::Init
 */
 bool Settings::Init()
 {
+    difficulty = chosenDifficulty = libCast<Settings::difficulty_t>(game.cfg.GetInt("Difficulty", DEFAULT_DIFFICULTY));
+    marksEnabled = game.cfg.GetBool("MarksEnabled", DEFAULT_MARKS_ENABLED);
+    noGuess = game.cfg.GetBool("NoGuess", DEFAULT_NO_GUESS);
+    customWidth = game.cfg.GetInt("CustomWidth", DEFAULT_CUSTOM_WIDTH);
+    customHeight = game.cfg.GetInt("CustomHeight", DEFAULT_CUSTOM_HEIGHT);
+    customMines = game.cfg.GetInt("CustomMines", DEFAULT_CUSTOM_MINES);
+
+    return true;
+}
+
+/*
+===================
+Settings::Load
+
+Loads the settings screen resources the first time it is shown.
+===================
+*/
+bool Settings::Load()
+{
+    if (loaded)
+        return true;
+
     engine->Get(mesh_marks.Get());
     engine->Get(mesh_sound.Get());
     engine->Get(mesh_mine.Get());
     engine->Get(mesh_crossout.Get());
 
+    // Not shared through the cache, the size and shadow set here would change the game's font as well
     LIB_CHECK(engine->Get(font.Get(), DATA_PACK "Font.ttf"));
-    LIB_CHECK(engine->Get(tex_button.Get(), DATA_PACK "Textures/Tile.tga"));
-    LIB_CHECK(engine->Get(tex_buttonPressed.Get(), DATA_PACK "Textures/TileOpen.tga"));
-    LIB_CHECK(engine->Get(tex_inputField.Get(), DATA_PACK "Textures/InputField.tga"));
-    LIB_CHECK(engine->Get(tex_question.Get(), DATA_PACK "Textures/Question.tga"));
-    LIB_CHECK(engine->Get(tex_soundOn.Get(), DATA_PACK "Textures/SoundOn.tga"));
-    LIB_CHECK(engine->Get(tex_soundOff.Get(), DATA_PACK "Textures/SoundOff.tga"));
-    LIB_CHECK(engine->Get(tex_mine.Get(), DATA_PACK "Textures/Mine.tga"));
-
-    difficulty = chosenDifficulty = libCast<Settings::difficulty_t>(game.cfg.GetInt("Difficulty", DEFAULT_DIFFICULTY));
-    marksEnabled = game.cfg.GetBool("MarksEnabled", DEFAULT_MARKS_ENABLED);
-    customWidth = game.cfg.GetInt("CustomWidth", DEFAULT_CUSTOM_WIDTH);
-    customHeight = game.cfg.GetInt("CustomHeight", DEFAULT_CUSTOM_HEIGHT);
-    customMines = game.cfg.GetInt("CustomMines", DEFAULT_CUSTOM_MINES);
+    LIB_CHECK(game.assets.Get(tex_button, DATA_PACK "Textures/Tile.tga"));
+    LIB_CHECK(game.assets.Get(tex_buttonPressed, DATA_PACK "Textures/TileOpen.tga"));
+    LIB_CHECK(game.assets.Get(tex_inputField, DATA_PACK "Textures/InputField.tga"));
+    LIB_CHECK(game.assets.Get(tex_question, DATA_PACK "Textures/Question.tga"));
+    LIB_CHECK(game.assets.Get(tex_soundOn, DATA_PACK "Textures/SoundOn.tga"));
+    LIB_CHECK(game.assets.Get(tex_soundOff, DATA_PACK "Textures/SoundOff.tga"));
+    LIB_CHECK(game.assets.Get(tex_mine, DATA_PACK "Textures/Mine.tga"));
 
     font->SetAlign(LIB_CENTER);
     font->SetSize(10);
@@ -85,6 +102,10 @@ bool Settings::Init()
     buttonHeight.SetShadowType(libFont::NO_SHADOW);
     buttonMines.SetShadowType(libFont::NO_SHADOW);
 
+    buttonNoGuess.SetFont(font.Get());
+    buttonNoGuess.SetText(L"No guessing");
+    buttonNoGuess.SetTexture(noGuess ? tex_buttonPressed.Get() : tex_button.Get());
+
     buttonSave.SetFont(font.Get());
     buttonSave.SetTexture(tex_button.Get());
     buttonSave.SetTextScale(0.6f);
@@ -96,6 +117,7 @@ bool Settings::Init()
     buttonHelp.SetText(L"Help");
 
     difficultyButtons[chosenDifficulty].SetTexture(tex_buttonPressed.Get());
+    loaded = true;
 
     return true;
 }
@@ -109,6 +131,7 @@ void Settings::Update()
 {
     buttonMarks.Update();
     buttonSound.Update();
+    buttonNoGuess.Update();
     buttonMines.Update();
     buttonWidth.Update();
     buttonHeight.Update();
@@ -164,6 +187,7 @@ void Settings::Update()
         game.cfg.SetInt("CustomHeight", buttonHeight.text.ToInt());
         game.cfg.SetInt("CustomMines", buttonMines.text.ToInt());
         game.cfg.SetBool("MarksEnabled", marksEnabled);
+        game.cfg.SetBool("NoGuess", noGuess);
 
         game.ToggleSettings();
         return;
@@ -224,6 +248,13 @@ void Settings::Update()
     else
         buttonMarks.SetTexture(tex_button.Get());
 
+    // Takes effect from the next board, the current one may already be generated
+    if (buttonNoGuess.IsReleased())
+    {
+        noGuess = !noGuess;
+        buttonNoGuess.SetTexture(noGuess ? tex_buttonPressed.Get() : tex_button.Get());
+    }
+
     if (buttonSound.IsPressed())
         buttonSound.SetTexture(tex_buttonPressed.Get());
     else if (buttonSound.IsReleased())
@@ -331,10 +362,12 @@ void Settings::Draw()
 {
     libVec2i screenSize(engine->State(LIB_SCREEN_WIDTH), engine->State(LIB_SCREEN_HEIGHT));
 
+    // The rows above the toggles are laid out without the height the toggles add to the window
+    float layoutHeight = libCast<float>(screenSize.y - TOGGLE_ROWS_HEIGHT);
     float x = screenSize.x / 2.0f;
     float y = 0.0f;
     float width = font->Size() * 13.0f;
-    float height = screenSize.y * 0.09f;
+    float height = layoutHeight * 0.09f;
     float halfTile = TILE_SIZE / 2.0f;
     float size = screenSize.x * 0.1f;
     float iconUnpressed = size / 2.0f * 0.7f;
@@ -344,7 +377,7 @@ void Settings::Draw()
     libVec2 marksPos(MARGIN_X * 2.0f + size / 2.0f, MARGIN_Y * 2.0f + size / 2.0f);
     libVec2 soundPos(libCast<float>(screenSize.x) - (MARGIN_X * 2.0f + size / 2.0f), MARGIN_Y * 2.0f + size / 2.0f);
 
-    font->SetSize(screenSize.y / 100 * 5);
+    font->SetSize(libCast<int>(layoutHeight) / 100 * 5);
 
     buttonMarks.SetSize(size, size);
     buttonMarks.SetPosition(marksPos.x, marksPos.y);
@@ -376,7 +409,7 @@ void Settings::Draw()
 
     // Difficulty section
     font->SetColor(LIB_COLOR_WHITE);
-    font->SetSize(screenSize.y / 100 * 5);
+    font->SetSize(libCast<int>(layoutHeight) / 100 * 5);
     y = libCast<float>(font->LineHeight());
     font->Print2D(x, y, "Difficulty");
 
@@ -433,6 +466,13 @@ void Settings::Draw()
     buttonHeight.Draw();
     buttonMines.Draw();
 
+    y += height * 1.3f;
+
+    buttonNoGuess.SetTextScale(0.5f);
+    buttonNoGuess.SetSize(width, height);
+    buttonNoGuess.SetPosition(x, y);
+    buttonNoGuess.Draw();
+
     y = screenSize.y - MARGIN_Y * 2 - buttonSave.size.y / 2.0f;
 
     buttonSave.SetSize(screenSize.x * 0.4f, height);
@@ -27,7 +27,9 @@
 #define DEFAULT_CUSTOM_HEIGHT       20
 #define DEFAULT_CUSTOM_MINES        145
 #define DEFAULT_MARKS_ENABLED       true
+#define DEFAULT_NO_GUESS            false
 #define DEFAULT_AUDIO_VOLUME        0.4f
+#define TOGGLE_ROWS_HEIGHT          50
 
 class Game;
 
@@ -54,6 +56,7 @@ public:
                         Settings(Game &game) : game(game){}
 
     bool                Init();
+    bool                Load();
     void                Update();
     void                Draw();
 
@@ -62,6 +65,7 @@ public:
     int                 CustomHeight() const { return customHeight; }
     int                 CustomMines() const { return customMines; }
     bool                MarksEnabled() const { return marksEnabled; }
+    bool                NoGuess() const { return noGuess; }
 
 private:
 
@@ -73,9 +77,12 @@ private:
     difficulty_t        difficulty = DEFAULT_DIFFICULTY;
     difficulty_t        chosenDifficulty = DEFAULT_DIFFICULTY;
     bool                marksEnabled = true;
+    bool                noGuess = DEFAULT_NO_GUESS;
+    bool                loaded = false;
 
     libButton           difficultyButtons[5];
     libButton           buttonMarks;
+    libButton           buttonNoGuess;
     libButton           buttonSound;
     libButton           buttonMines;
     libButton           buttonWidth;
@@ -0,0 +1,233 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "SharedMemory.h"
+
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+/*
+===================
+SharedMemory::Create
+===================
+*/
+bool SharedMemory::Create(const char *name, size_t size)
+{
+    Close();
+
+    path = std::string("Local\\") + name;
+    handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                static_cast<DWORD>(size), path.c_str());
+
+    if (!handle)
+    {
+        error = "Couldn't create the file mapping.";
+        return false;
+    }
+
+    // The existing mapping has been opened instead, it belongs to another host
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        Close();
+        error = "The name is already used by another host.";
+        return false;
+    }
+
+    data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+    if (!data)
+    {
+        Close();
+        error = "Couldn't map the file mapping.";
+        return false;
+    }
+
+    this->size = size;
+    owner = true;
+
+    return true;
+}
+
+/*
+===================
+SharedMemory::Open
+===================
+*/
+bool SharedMemory::Open(const char *name, size_t size)
+{
+    Close();
+
+    path = std::string("Local\\") + name;
+    handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path.c_str());
+
+    if (!handle)
+        return false;
+
+    data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+    if (!data)
+    {
+        Close();
+        return false;
+    }
+
+    this->size = size;
+
+    return true;
+}
+
+/*
+===================
+SharedMemory::Close
+
+The mapping goes away with the last handle to it.
+===================
+*/
+void SharedMemory::Close()
+{
+    if (data)
+        UnmapViewOfFile(data);
+
+    if (handle)
+        CloseHandle(handle);
+
+    data = nullptr;
+    handle = nullptr;
+    size = 0;
+    owner = false;
+    error = "";
+}
+
+#else
+
+/*
+===================
+SharedMemory::Create
+
+A segment that is left behind by a host that crashed has to be removed from /dev/shm by hand.
+===================
+*/
+bool SharedMemory::Create(const char *name, size_t size)
+{
+    Close();
+
+    path = std::string("/") + name;
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (fd < 0)
+    {
+        error = errno == EEXIST ? "The name is already used by another host, or left behind in /dev/shm by one that crashed." :
+                                  "Couldn't create the shared memory object.";
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        close(fd);
+        shm_unlink(path.c_str());
+        error = "Couldn't resize the shared memory object.";
+        return false;
+    }
+
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+    {
+        shm_unlink(path.c_str());
+        error = "Couldn't map the shared memory object.";
+        return false;
+    }
+
+    data = mapped;
+    this->size = size;
+    owner = true;
+
+    return true;
+}
+
+/*
+===================
+SharedMemory::Open
+===================
+*/
+bool SharedMemory::Open(const char *name, size_t size)
+{
+    Close();
+
+    path = std::string("/") + name;
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+
+    // Smaller than expected, an older host or one that is still starting
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < size)
+    {
+        close(fd);
+        return false;
+    }
+
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+        return false;
+
+    data = mapped;
+    this->size = size;
+
+    return true;
+}
+
+/*
+===================
+SharedMemory::Close
+===================
+*/
+void SharedMemory::Close()
+{
+    if (data)
+        munmap(data, size);
+
+    if (owner)
+        shm_unlink(path.c_str());
+
+    data = nullptr;
+    size = 0;
+    owner = false;
+    error = "";
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/*
+===========================================================
+
+    SharedMemory
+
+    A named block of memory that other processes can map as well. The
+    process that creates it removes the name again when it's closed.
+    Creating a name that is already in use fails, Error() tells why.
+
+===========================================================
+*/
+class SharedMemory
+{
+public:
+
+                        SharedMemory() = default;
+                        SharedMemory(const SharedMemory &) = delete;
+                        ~SharedMemory() { Close(); }
+
+    SharedMemory &      operator=(const SharedMemory &) = delete;
+
+    bool                Create(const char *name, size_t size);
+    bool                Open(const char *name, size_t size);
+    void                Close();
+
+    void *              Data() const { return data; }
+    bool                IsOpen() const { return data != nullptr; }
+    const char *        Error() const { return error; }
+
+private:
+
+    void *              data = nullptr;
+    size_t              size = 0;
+    bool                owner = false;
+    std::string         path;
+    const char *        error = "";
+#ifdef _WIN32
+    void *              handle = nullptr;
+#endif
+};
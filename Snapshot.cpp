@@ -0,0 +1,358 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Snapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/*
+===================
+Checksum
+
+FNV-1a over the payload.
+===================
+*/
+static uint32_t Checksum(const uint8_t *data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ data[i]) * 16777619u;
+
+    return hash;
+}
+
+/*
+===================
+Put
+===================
+*/
+template<typename type_t>
+static void Put(std::vector<uint8_t> &data, type_t value)
+{
+    size_t offset = data.size();
+    data.resize(offset + sizeof(value));
+    memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+/*
+===================
+Get
+===================
+*/
+template<typename type_t>
+static bool Get(const std::vector<uint8_t> &data, size_t &offset, type_t &value)
+{
+    if (data.size() - offset < sizeof(value))
+        return false;
+
+    memcpy(&value, data.data() + offset, sizeof(value));
+    offset += sizeof(value);
+
+    return true;
+}
+
+/*
+===================
+Snapshot::Capture
+===================
+*/
+void Snapshot::Capture(const Board &board)
+{
+    size_t size = board.Size();
+
+    width = board.Width();
+    height = board.Height();
+    mines = board.Mines();
+    mined.assign((size + 7) / 8, 0);
+    states.assign((size + 3) / 4, 0);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        const Tile &tile = board[static_cast<int>(i)];
+
+        if (tile.type == Tile::MINED)
+            mined[i >> 3] |= 1 << (i & 7);
+
+        states[i >> 2] |= tile.state << ((i & 3) * 2);
+    }
+}
+
+/*
+===================
+Snapshot::Restore
+===================
+*/
+void Snapshot::Restore(Board &board) const
+{
+    int size = width * height;
+    std::vector<int> mineTiles;
+    std::vector<Tile::state_t> tileStates(size);
+
+    for (int i = 0; i < size; i++)
+    {
+        if (mined[i >> 3] & (1 << (i & 7)))
+            mineTiles.push_back(i);
+
+        tileStates[i] = static_cast<Tile::state_t>((states[i >> 2] >> ((i & 3) * 2)) & 3);
+    }
+
+    board.Reset(width, height, mines);
+    board.PlaceMines(mineTiles);
+    board.SetStates(tileStates);
+}
+
+/*
+===================
+Snapshot::Write
+
+The magic and version, the size of the payload, the payload and its checksum.
+===================
+*/
+void Snapshot::Write(std::vector<uint8_t> &bytes) const
+{
+    bytes.clear();
+    Put(bytes, static_cast<uint32_t>(SNAPSHOT_MAGIC));
+    Put(bytes, static_cast<uint32_t>(SNAPSHOT_VERSION));
+    Put(bytes, static_cast<uint32_t>(0));
+
+    size_t start = bytes.size();
+
+    Put(bytes, width);
+    Put(bytes, height);
+    Put(bytes, mines);
+    bytes.insert(bytes.end(), mined.begin(), mined.end());
+    bytes.insert(bytes.end(), states.begin(), states.end());
+
+    Put(bytes, seed);
+    Put(bytes, firstClickX);
+    Put(bytes, firstClickY);
+    Put(bytes, milliseconds);
+    Put(bytes, leftClicks);
+    Put(bytes, rightClicks);
+    Put(bytes, chordClicks);
+    Put(bytes, difficulty);
+
+    Put(bytes, autoWidth);
+    Put(bytes, autoHeight);
+    Put(bytes, mineRatio);
+    Put(bytes, belief);
+
+    replay.Write(bytes);
+
+    uint32_t size = static_cast<uint32_t>(bytes.size() - start);
+    memcpy(bytes.data() + start - sizeof(size), &size, sizeof(size));
+    Put(bytes, Checksum(bytes.data() + start, size));
+}
+
+/*
+===================
+Snapshot::Read
+===================
+*/
+bool Snapshot::Read(const std::vector<uint8_t> &bytes)
+{
+    size_t offset = 0;
+    uint32_t magic = 0, version = 0, size = 0, checksum = 0;
+
+    if (!Get(bytes, offset, magic) || magic != SNAPSHOT_MAGIC || !Get(bytes, offset, version) || version != SNAPSHOT_VERSION ||
+        !Get(bytes, offset, size) || size != bytes.size() - offset - sizeof(checksum))
+        return false;
+
+    size_t start = offset;
+    memcpy(&checksum, bytes.data() + start + size, sizeof(checksum));
+
+    if (Checksum(bytes.data() + start, size) != checksum)
+        return false;
+
+    if (!Get(bytes, offset, width) || !Get(bytes, offset, height) || !Get(bytes, offset, mines) ||
+        !width || !height || width > 0xFFFF || height > 0xFFFF || mines >= width * height)
+        return false;
+
+    size_t tiles = static_cast<size_t>(width) * height;
+    size_t bitmap = (tiles + 7) / 8, packed = (tiles + 3) / 4;
+
+    if (bitmap + packed > size)
+        return false;
+
+    mined.assign(bytes.begin() + offset, bytes.begin() + offset + bitmap);
+    offset += bitmap;
+    states.assign(bytes.begin() + offset, bytes.begin() + offset + packed);
+    offset += packed;
+
+    bool read = Get(bytes, offset, seed) && Get(bytes, offset, firstClickX) && Get(bytes, offset, firstClickY) &&
+                Get(bytes, offset, milliseconds) && Get(bytes, offset, leftClicks) && Get(bytes, offset, rightClicks) &&
+                Get(bytes, offset, chordClicks) && Get(bytes, offset, difficulty) &&
+                Get(bytes, offset, autoWidth) && Get(bytes, offset, autoHeight) && Get(bytes, offset, mineRatio) &&
+                Get(bytes, offset, belief);
+
+    // The replay is of the same game
+    return read && replay.Read(bytes, offset) && offset == start + size &&
+           replay.header.width == width && replay.header.height == height;
+}
+
+/*
+===================
+Snapshot::Load
+===================
+*/
+bool Snapshot::Load(const char *path)
+{
+    FILE *file = std::fopen(path, "rb");
+
+    if (!file)
+        return false;
+
+    std::vector<uint8_t> bytes;
+    uint8_t block[65536];
+    size_t size;
+
+    while ((size = std::fread(block, 1, sizeof(block), file)) > 0)
+        bytes.insert(bytes.end(), block, block + size);
+
+    std::fclose(file);
+
+    return Read(bytes);
+}
+
+/*
+===================
+Autosave::Save
+===================
+*/
+void Autosave::Save(Snapshot &snapshot)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::swap(pending, snapshot);
+    saving = true;
+    removing = false;
+
+    if (!writer.joinable())
+        writer = std::thread(&Autosave::Write, this);
+
+    wake.notify_one();
+}
+
+/*
+===================
+Autosave::Remove
+===================
+*/
+void Autosave::Remove()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    saving = false;
+    removing = true;
+
+    if (!writer.joinable())
+        writer = std::thread(&Autosave::Write, this);
+
+    wake.notify_one();
+}
+
+/*
+===================
+Autosave::Stop
+===================
+*/
+void Autosave::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        wake.notify_one();
+    }
+
+    if (writer.joinable())
+        writer.join();
+
+    stop = false;
+}
+
+/*
+===================
+Autosave::Write
+
+Only the latest snapshot matters, the ones that came in while writing are skipped.
+===================
+*/
+void Autosave::Write()
+{
+    Snapshot writing;
+    std::vector<uint8_t> bytes;
+    std::string temporary = path + ".tmp";
+
+    for (;;)
+    {
+        bool remove = false;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stop || saving || removing; });
+
+            if (saving)
+                std::swap(writing, pending);
+            else if (!removing)
+                return;
+
+            remove = removing;
+            saving = false;
+            removing = false;
+        }
+
+        std::error_code error;
+
+        if (remove)
+        {
+            std::filesystem::remove(path, error);
+            continue;
+        }
+
+        writing.Write(bytes);
+
+        FILE *file = std::fopen(temporary.c_str(), "wb");
+
+        if (!file)
+            continue;
+
+        bool written = std::fwrite(bytes.data(), bytes.size(), 1, file) == 1 && !std::fflush(file);
+
+#ifdef _WIN32
+        written = written && !_commit(_fileno(file));
+#else
+        written = written && !fsync(fileno(file));
+#endif
+
+        // The old snapshot stays until the new one is complete on the disk
+        if (std::fclose(file) == 0 && written)
+            std::filesystem::rename(temporary, path, error);
+        else
+            std::filesystem::remove(temporary, error);
+    }
+}
@@ -0,0 +1,130 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Board.h"
+#include "Replay.h"
+#include "AutoDifficulty.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SNAPSHOT_MAGIC              0x5353464D // "MFSS"
+#define SNAPSHOT_VERSION            1
+
+/*
+===========================================================
+
+    Snapshot
+
+    Everything needed to go on with a game after the program is
+    closed: the field as a mine bitmap and the tile states in 2 bits
+    each, the counters, the clock, the first click, the state of the
+    Auto difficulty and the replay recorded so far.
+
+    A full 70x35 field takes about a kilobyte.
+
+===========================================================
+*/
+class Snapshot
+{
+public:
+
+    // Only generated boards, there is nothing to go on with before the first click
+    void                Capture(const Board &board);
+    void                Restore(Board &board) const;
+
+    void                Write(std::vector<uint8_t> &bytes) const;
+    bool                Read(const std::vector<uint8_t> &bytes);
+
+    bool                Load(const char *path);
+
+    uint32_t            width = 0;
+    uint32_t            height = 0;
+    uint32_t            mines = 0;
+    std::vector<uint8_t> mined;             // A bit for every tile
+    std::vector<uint8_t> states;            // 2 bits for every tile
+
+    uint64_t            seed = 0;           // 0 if the board has none
+    int                 firstClickX = 0;
+    int                 firstClickY = 0;
+    uint32_t            milliseconds = 0;   // On the game's clock
+    int                 leftClicks = 0;
+    int                 rightClicks = 0;
+    int                 chordClicks = 0;
+    int                 difficulty = 0;     // Like Settings::difficulty_t
+
+    int                 autoWidth = 0;
+    int                 autoHeight = 0;
+    float               mineRatio = 0.0f;
+    AutoDifficulty::belief_t belief;
+
+    Replay              replay;
+};
+
+/*
+===========================================================
+
+    Autosave
+
+    Writes snapshots on a thread of its own. The game hands over a
+    snapshot it has just filled and gets the previous buffer back to
+    fill the next time, so saving never waits for the disk.
+
+    The file is written to a temporary one first and renamed over the
+    old one, so there is always either the old or the new snapshot.
+
+===========================================================
+*/
+class Autosave
+{
+public:
+
+                        ~Autosave() { Stop(); }
+
+    void                SetPath(const char *path) { this->path = path; }
+
+    // Swaps the snapshot with the one waiting to be written
+    void                Save(Snapshot &snapshot);
+
+    // There is no game to go on with anymore
+    void                Remove();
+
+    // Waits until everything has been written
+    void                Stop();
+
+private:
+
+    void                Write();
+
+    std::string         path;
+    Snapshot            pending;
+    bool                saving = false;
+    bool                removing = false;
+
+    std::mutex          mutex;
+    std::condition_variable wake;
+    std::thread         writer;
+    bool                stop = false;
+};
@@ -0,0 +1,371 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "Solver.h"
+
+#include <algorithm>
+
+/*
+===================
+Solver::Reset
+
+Rebuilds everything from the tiles that are currently visible.
+===================
+*/
+void Solver::Reset(const Board &board)
+{
+    this->board = &board;
+    generation = board.Generation();
+    reverts = board.Reverts();
+    changesRead = board.Changes().size();
+
+    knowledge.assign(board.Size(), UNKNOWN);
+    queued.assign(board.Size(), 0);
+    constraints.resize(board.Size());
+    cached.assign(board.Size(), 0);
+    queue.clear();
+    safe.clear();
+    mines.clear();
+    unknown = board.Size();
+    knownMines = 0;
+
+    for (int i = 0; i < board.Size(); i++)
+    {
+        const Tile &tile = board[i];
+
+        if (tile.state == Tile::OPEN)
+            Learn(i, tile.type == Tile::MINED ? MINE : SAFE);
+        else if (trustFlags && tile.state == Tile::FLAGGED)
+            Learn(i, MINE);
+    }
+
+    Update(board);
+}
+
+/*
+===================
+Solver::Update
+
+Catches up with the tiles opened since the last call. A new game, an undone
+move, or a flag change while flags are trusted, falls back to a full rebuild.
+===================
+*/
+void Solver::Update(const Board &board)
+{
+    if (this->board != &board || generation != board.Generation() || reverts != board.Reverts())
+    {
+        Reset(board);
+        return;
+    }
+
+    const std::vector<int> &changes = board.Changes();
+
+    for (; changesRead < changes.size(); changesRead++)
+    {
+        int index = changes[changesRead];
+        const Tile &tile = board[index];
+
+        if (tile.state != Tile::OPEN)
+        {
+            // Flags aren't evidence of anything unless we trust them
+            if (trustFlags)
+            {
+                Reset(board);
+                return;
+            }
+
+            continue;
+        }
+
+        if (trustFlags && knowledge[index] == MINE && tile.type != Tile::MINED)
+        {
+            Reset(board);
+            return;
+        }
+
+        // A newly opened number is a new constraint even if the tile itself was already known to be safe
+        Learn(index, tile.type == Tile::MINED ? MINE : SAFE);
+        Enqueue(index);
+    }
+
+    do
+    {
+        while (!queue.empty())
+        {
+            int index = queue.back();
+            queue.pop_back();
+            queued[index] = 0;
+
+            Process(index);
+        }
+
+        ApplyGlobal();
+    } while (!queue.empty());
+
+    safe.erase(std::remove_if(safe.begin(), safe.end(), [&board](int index) { return board[index].state == Tile::OPEN; }), safe.end());
+}
+
+/*
+===================
+Solver::UnknownMines
+===================
+*/
+int Solver::UnknownMines() const
+{
+    return board ? board->Mines() - knownMines : 0;
+}
+
+/*
+===================
+Solver::GetConstraint
+
+Returns nullptr if the tile isn't an open number or contradicts what's already known.
+===================
+*/
+const Solver::constraint_t *Solver::GetConstraint(int index) const
+{
+    const Tile &tile = (*board)[index];
+
+    if (tile.state != Tile::OPEN || tile.type == Tile::MINED)
+        return nullptr;
+
+    // Every number is looked at by all numbers around it, so it's only built again once a neighbor is learned
+    if (!cached[index])
+    {
+        constraint_t &built = constraints[index];
+        int x = board->X(index), y = board->Y(index);
+        built.count = 0;
+        built.mines = tile.nearestMines;
+
+        for (int j = y - 1; j <= y + 1; j++)
+        {
+            for (int i = x - 1; i <= x + 1; i++)
+            {
+                if (!board->IsInside(i, j))
+                    continue;
+
+                int neighbor = board->Index(i, j);
+
+                if (knowledge[neighbor] == MINE)
+                    built.mines--;
+                else if (knowledge[neighbor] == UNKNOWN)
+                    built.tiles[built.count++] = neighbor;
+            }
+        }
+
+        cached[index] = 1;
+    }
+
+    const constraint_t &constraint = constraints[index];
+    return constraint.mines >= 0 && constraint.mines <= constraint.count ? &constraint : nullptr;
+}
+
+/*
+===================
+Solver::Process
+
+Applies the single-point rule to a number, then the pair rule against every number close enough to share a tile with it.
+===================
+*/
+void Solver::Process(int index)
+{
+    const constraint_t *found = GetConstraint(index);
+
+    if (!found || !found->count)
+        return;
+
+    // Learning something rebuilds the cached one, so this keeps its own copy
+    constraint_t constraint = *found;
+
+    if (!constraint.mines || constraint.mines == constraint.count)
+    {
+        knowledge_t value = constraint.mines ? MINE : SAFE;
+
+        for (int i = 0; i < constraint.count; i++)
+            Learn(constraint.tiles[i], value);
+
+        return;
+    }
+
+    int x = board->X(index), y = board->Y(index);
+
+    for (int j = y - 2; j <= y + 2; j++)
+    {
+        for (int i = x - 2; i <= x + 2; i++)
+        {
+            if (!board->IsInside(i, j) || (i == x && j == y))
+                continue;
+
+            const constraint_t *other = GetConstraint(board->Index(i, j));
+
+            if (!other || !other->count)
+                continue;
+
+            ApplyPair(constraint, *other);
+
+            // Whatever was learned will bring this number back through the queue
+            if (queued[index])
+                return;
+        }
+    }
+}
+
+/*
+===================
+Solver::ApplyPair
+
+If A has exactly as many more mines than B as it has tiles B doesn't see,
+all of those tiles are mines and all tiles only B sees are safe.
+This covers the subset/superset rule as well.
+===================
+*/
+void Solver::ApplyPair(const constraint_t &a, const constraint_t &b)
+{
+    int onlyA[8], onlyB[8];
+    int countA = 0, countB = 0;
+
+    for (int i = 0; i < a.count; i++)
+        if (std::find(b.tiles, b.tiles + b.count, a.tiles[i]) == b.tiles + b.count)
+            onlyA[countA++] = a.tiles[i];
+
+    // Nothing in common, so nothing to compare
+    if (countA == a.count)
+        return;
+
+    for (int i = 0; i < b.count; i++)
+        if (std::find(a.tiles, a.tiles + a.count, b.tiles[i]) == a.tiles + a.count)
+            onlyB[countB++] = b.tiles[i];
+
+    // The same tiles
+    if (!countA && !countB)
+        return;
+
+    knowledge_t valueA, valueB;
+
+    // With no tiles of its own, a number that needs as many mines as the other makes the other's own tiles safe
+    if (a.mines - b.mines == countA)
+    {
+        valueA = MINE;
+        valueB = SAFE;
+    }
+    else if (b.mines - a.mines == countB)
+    {
+        valueA = SAFE;
+        valueB = MINE;
+    }
+    else
+    {
+        return;
+    }
+
+    for (int i = 0; i < countA; i++)
+        Learn(onlyA[i], valueA);
+
+    for (int i = 0; i < countB; i++)
+        Learn(onlyB[i], valueB);
+}
+
+/*
+===================
+Solver::ApplyGlobal
+
+Once every remaining mine is accounted for, or there are as many unknown tiles as mines, the rest follows.
+===================
+*/
+void Solver::ApplyGlobal()
+{
+    if (!board->IsGenerated() || !unknown)
+        return;
+
+    int minesLeft = UnknownMines();
+
+    if (minesLeft && minesLeft != unknown)
+        return;
+
+    knowledge_t value = minesLeft ? MINE : SAFE;
+
+    for (int i = 0; i < board->Size(); i++)
+        if (knowledge[i] == UNKNOWN)
+            Learn(i, value);
+}
+
+/*
+===================
+Solver::Learn
+===================
+*/
+void Solver::Learn(int index, knowledge_t value)
+{
+    if (knowledge[index] != UNKNOWN)
+        return;
+
+    knowledge[index] = value;
+    unknown--;
+
+    if (value == MINE)
+        knownMines++;
+
+    if ((*board)[index].state != Tile::OPEN)
+    {
+        if (value == MINE)
+            mines.push_back(index);
+        else
+            safe.push_back(index);
+    }
+
+    EnqueueNeighbors(index);
+}
+
+/*
+===================
+Solver::Enqueue
+===================
+*/
+void Solver::Enqueue(int index)
+{
+    if (queued[index])
+        return;
+
+    queued[index] = 1;
+    queue.push_back(index);
+}
+
+/*
+===================
+Solver::EnqueueNeighbors
+
+Only numbers next to a tile can be affected by it.
+===================
+*/
+void Solver::EnqueueNeighbors(int index)
+{
+    int x = board->X(index), y = board->Y(index);
+
+    for (int j = y - 1; j <= y + 1; j++)
+    {
+        for (int i = x - 1; i <= x + 1; i++)
+        {
+            if (board->IsInside(i, j) && (*board)[board->Index(i, j)].state == Tile::OPEN)
+            {
+                cached[board->Index(i, j)] = 0;
+                Enqueue(board->Index(i, j));
+            }
+        }
+    }
+}
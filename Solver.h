@@ -0,0 +1,102 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include "Board.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+===========================================================
+
+    Solver
+
+    Deterministic deductions from the numbers on the board, using only
+    what the player can see. Every open number is a constraint over its
+    closed neighbors. Two rules are applied until nothing changes:
+    the single-point rule (a number is already satisfied, or all of its
+    unknown neighbors have to be mines) and the subset/superset rule
+    between two numbers that share unknown neighbors.
+
+    Update() reads the board's change journal and re-examines only the
+    numbers around the tiles that changed.
+
+===========================================================
+*/
+class Solver
+{
+public:
+
+    enum knowledge_t : uint8_t
+    {
+        UNKNOWN,
+        SAFE,
+        MINE
+    };
+
+    void                Reset(const Board &board);
+    void                Update(const Board &board);
+
+    knowledge_t         Knowledge(int index) const { return knowledge[index]; }
+
+    // Closed tiles that are proven to be safe or mined
+    const std::vector<int> &SafeTiles() const { return safe; }
+    const std::vector<int> &MineTiles() const { return mines; }
+
+    // Tiles nobody knows anything about yet, and how many mines they hide
+    int                 UnknownTiles() const { return unknown; }
+    int                 UnknownMines() const;
+
+    // Treats flags as proven mines, the player has to be right about them
+    bool                trustFlags = false;
+
+private:
+
+    struct constraint_t
+    {
+        int             tiles[8];
+        int             count;
+        int             mines;
+    };
+
+    const constraint_t *GetConstraint(int index) const;
+    void                Process(int index);
+    void                ApplyPair(const constraint_t &a, const constraint_t &b);
+    void                ApplyGlobal();
+    void                Learn(int index, knowledge_t value);
+    void                Enqueue(int index);
+    void                EnqueueNeighbors(int index);
+
+    const Board *       board = nullptr;
+    std::vector<knowledge_t> knowledge;
+    mutable std::vector<constraint_t> constraints;
+    mutable std::vector<uint8_t> cached;
+    std::vector<uint8_t> queued;
+    std::vector<int>    queue;
+    std::vector<int>    safe;
+    std::vector<int>    mines;
+    size_t              changesRead = 0;
+    unsigned            generation = 0;
+    unsigned            reverts = 0;
+    int                 unknown = 0;
+    int                 knownMines = 0;
+};
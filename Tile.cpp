@@ -17,7 +17,6 @@
 ===============================================================================
 */
 
-#include "Main.h"
 #include "Tile.h"
 
 /*
@@ -30,9 +29,6 @@ void Tile::Reset()
     type = EMPTY;
     state = CLOSED;
     nearestMines = 0;
-
-    button.SetEnabled(true);
-    button.textureColor.base = libColor();
 }
 
 /*
@@ -19,7 +19,7 @@
 
 #pragma once
 
-#include "Main.h"
+#include <cstdint>
 
 /*
 ===========================================================
@@ -32,13 +32,13 @@ class Tile
 {
 public:
 
-    enum type_t : libUint8
+    enum type_t : uint8_t
     {
         EMPTY,
         MINED
     };
 
-    enum state_t : libUint8
+    enum state_t : uint8_t
     {
         CLOSED,
         OPEN,
@@ -54,8 +54,7 @@ public:
     bool            IsIncorrectlyFlaggedOrMined() const;
     bool            HasNoNearestMines() const;
 
-    libButton       button;
-    int             nearestMines;
     type_t          type;
     state_t         state;
+    uint8_t         nearestMines;
 };
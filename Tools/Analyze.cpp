@@ -0,0 +1,637 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Runs deductions and exact probabilities over positions recorded as text, on all cores.
+// Usage: MinefieldAnalyze <input, - for stdin> <output> [threads]
+//        MinefieldAnalyze --check
+//
+// A position is a line with its width, height and number of mines, followed by one line
+// per row: 0-8 or . for open tiles, # H or - for closed ones, F or * for flags.
+// Positions are separated by empty lines, lines starting with ; are skipped. One with too few
+// or too many rows is a parse error, and the next one is still read from its own header.
+//
+// The output starts with "MFAN", the version and the size of a record, then has one record
+// per position in input order, all little-endian:
+//     uint32 line, uint8 status, uint8 reserved, uint16 components, uint16 width, uint16 height,
+//     uint32 mines, uint32 safe, uint32 mined, uint32 unknown, uint32 best tile,
+//     float best probability, float interior probability
+// Safe and mined are closed tiles the solver has proven, the best tile is the closed tile
+// least likely to be a mine, 0xFFFFFFFF and -1 if the probabilities couldn't be computed.
+
+#include "../Probability.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ANALYZE_MAGIC               "MFAN"
+#define ANALYZE_VERSION             1
+#define ANALYZE_RECORD_BYTES        40
+#define ANALYZE_BATCH               256     // Positions handed to a thread at once
+#define ANALYZE_BATCHES_PER_THREAD  4       // Batches in flight per thread, which bounds the memory
+#define ANALYZE_MAX_SIZE            1024    // Largest width and height accepted
+#define ANALYZE_NO_TILE             0xFFFFFFFFu
+
+enum status_t : uint8_t
+{
+    EXACT,                                  // Probabilities are exact
+    TOO_BIG,                                // Only the deductions, the frontier was too big to count
+    CONTRADICTION,                          // No placement of mines fits the numbers
+    PARSE_ERROR
+};
+
+struct position_t
+{
+    uint32_t            line = 0;
+    int                 width = 0;
+    int                 height = 0;
+    int                 mines = 0;
+    bool                parsed = false;
+    std::string         cells;              // Row by row
+};
+
+struct batch_t
+{
+    uint64_t            index = 0;
+    std::vector<position_t> positions;
+    std::vector<uint8_t> output;
+};
+
+/*
+===========================================================
+
+    pipeline_t
+
+    The reader hands out batches of positions, threads analyze them in
+    any order and the writer puts them back in input order. There are
+    never more than a few batches per thread between the reader and
+    the writer, so memory stays the same however big the input is.
+
+===========================================================
+*/
+struct pipeline_t
+{
+    std::mutex          mutex;
+    std::condition_variable changed;
+    std::deque<std::unique_ptr<batch_t>> queued;
+    std::map<uint64_t, std::unique_ptr<batch_t>> done;
+    int                 inFlight = 0;
+    int                 maxInFlight = 0;
+    bool                finished = false;   // The reader has nothing more
+};
+
+struct totals_t
+{
+    uint64_t            positions = 0;
+    uint64_t            statuses[PARSE_ERROR + 1] = {};
+    uint64_t            safe = 0;
+    uint64_t            mined = 0;
+};
+
+/*
+===================
+Put
+===================
+*/
+static void Put(std::vector<uint8_t> &output, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        output.push_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+/*
+===================
+PutFloat
+===================
+*/
+static void PutFloat(std::vector<uint8_t> &output, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Put(output, bits, 4);
+}
+
+/*
+===================
+TrimLine
+===================
+*/
+static void TrimLine(std::string &line)
+{
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r' || line.back() == ' ' || line.back() == '\t'))
+        line.pop_back();
+}
+
+/*
+===================
+ReadLine
+===================
+*/
+static bool ReadLine(FILE *file, std::string &line, uint32_t &number)
+{
+    char buffer[4096];
+    line.clear();
+
+    if (!fgets(buffer, sizeof(buffer), file))
+        return false;
+
+    line = buffer;
+
+    // Longer than the buffer, which no row or header is. The rest is dropped so the line can't
+    // grow without bound, and what is kept is still too long to pass as a row.
+    if (!strchr(buffer, '\n'))
+    {
+        while (fgets(buffer, sizeof(buffer), file) && !strchr(buffer, '\n'))
+            ;
+    }
+
+    TrimLine(line);
+    number++;
+
+    return true;
+}
+
+/*
+===================
+ReadPosition
+
+Returns false at the end of the input. A position that can't be parsed is still returned, with parsed unset.
+===================
+*/
+static bool ReadPosition(FILE *file, position_t &position, uint32_t &number)
+{
+    std::string line;
+
+    do
+    {
+        if (!ReadLine(file, line, number))
+            return false;
+    } while (line.empty() || line[0] == ';');
+
+    position = position_t();
+    position.line = number;
+
+    if (sscanf(line.c_str(), "%d %d %d", &position.width, &position.height, &position.mines) != 3 ||
+        position.width < 1 || position.height < 1 || position.width > ANALYZE_MAX_SIZE || position.height > ANALYZE_MAX_SIZE ||
+        position.mines < 0 || position.mines >= position.width * position.height)
+    {
+        // Whatever rows it had are skipped with it
+        while (ReadLine(file, line, number) && !line.empty())
+            ;
+
+        return true;
+    }
+
+    position.cells.reserve(static_cast<size_t>(position.width) * position.height);
+    bool valid = true;
+
+    // A broken row still counts, so the next position is found where it should be. Rows stop
+    // at an empty line, so a position that is short doesn't take the header of the next one.
+    for (int y = 0; y < position.height; y++)
+    {
+        if (!ReadLine(file, line, number) || line.empty())
+            return true;
+
+        if (static_cast<int>(line.size()) != position.width || line.find_first_not_of("012345678.#H-F*") != std::string::npos)
+            valid = false;
+        else
+            position.cells += line;
+    }
+
+    // One that is long is rejected along with the rest of its rows
+    while (ReadLine(file, line, number) && !line.empty())
+    {
+        if (line[0] != ';')
+            valid = false;
+    }
+
+    position.parsed = valid;
+
+    return true;
+}
+
+/*
+===================
+IsPossible
+
+Numbers the solvers can't catch, because no closed tile is next to them.
+===================
+*/
+static bool IsPossible(const Board &board)
+{
+    for (int i = 0; i < board.Size(); i++)
+    {
+        if (board[i].state != Tile::OPEN)
+            continue;
+
+        int closed = 0;
+
+        for (int y = board.Y(i) - 1; y <= board.Y(i) + 1; y++)
+            for (int x = board.X(i) - 1; x <= board.X(i) + 1; x++)
+                if (board.IsInside(x, y) && board.At(x, y).state != Tile::OPEN)
+                    closed++;
+
+        if (board[i].nearestMines > closed)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+===================
+SetUp
+===================
+*/
+static void SetUp(const position_t &position, Board &board)
+{
+    board.Reset(position.width, position.height, position.mines);
+
+    for (int i = 0; i < board.Size(); i++)
+    {
+        char c = position.cells[i];
+
+        if (c >= '0' && c <= '8')
+            board.Reveal(board.X(i), board.Y(i), c - '0');
+        else if (c == '.')
+            board.Reveal(board.X(i), board.Y(i), 0);
+    }
+
+    // Flags only after the numbers, they are kept but not trusted
+    for (int i = 0; i < board.Size(); i++)
+        if (position.cells[i] == 'F' || position.cells[i] == '*')
+            board.ToggleFlag(board.X(i), board.Y(i), false);
+}
+
+/*
+===================
+Analyze
+===================
+*/
+static void Analyze(const position_t &position, Board &board, Solver &solver, Probability &probability, std::vector<uint8_t> &output)
+{
+    status_t status = PARSE_ERROR;
+    uint32_t safe = 0, mined = 0, unknown = 0, best = ANALYZE_NO_TILE;
+    float bestProbability = -1.0f, interior = -1.0f;
+    int components = 0;
+
+    if (position.parsed)
+    {
+        SetUp(position, board);
+        solver.Reset(board);
+        safe = static_cast<uint32_t>(solver.SafeTiles().size());
+        mined = static_cast<uint32_t>(solver.MineTiles().size());
+        unknown = static_cast<uint32_t>(solver.UnknownTiles());
+
+        if (!IsPossible(board))
+        {
+            status = CONTRADICTION;
+        }
+        else if (probability.Compute(board, solver))
+        {
+            status = EXACT;
+            components = probability.Components();
+            interior = probability.InteriorProbability();
+
+            for (int i = 0; i < board.Size(); i++)
+            {
+                if (board[i].state == Tile::OPEN || solver.Knowledge(i) == Solver::MINE)
+                    continue;
+
+                if (best == ANALYZE_NO_TILE || probability.At(i) < bestProbability)
+                {
+                    best = i;
+                    bestProbability = probability.At(i);
+                }
+            }
+        }
+        else
+        {
+            status = probability.IsTooBig() ? TOO_BIG : CONTRADICTION;
+        }
+    }
+
+    Put(output, position.line, 4);
+    Put(output, status, 1);
+    Put(output, 0, 1);
+    Put(output, static_cast<uint32_t>(components), 2);
+    Put(output, static_cast<uint32_t>(position.width), 2);
+    Put(output, static_cast<uint32_t>(position.height), 2);
+    Put(output, static_cast<uint32_t>(position.mines), 4);
+    Put(output, safe, 4);
+    Put(output, mined, 4);
+    Put(output, unknown, 4);
+    Put(output, best, 4);
+    PutFloat(output, bestProbability);
+    PutFloat(output, interior);
+}
+
+/*
+===================
+Check
+
+Positions whose results are known, for catching rules that stop firing and parsing that goes out of step.
+===================
+*/
+static int Check()
+{
+    struct check_t
+    {
+        int             width, height, mines;
+        const char *    cells;
+        status_t        status;
+        int             safe, mined;
+    };
+
+    static const check_t checks[] =
+    {
+        { 3, 2, 1, "###111", EXACT, 2, 1 },             // A number inside another that needs as many mines
+        { 3, 2, 2, "###121", EXACT, 1, 2 },             // A number inside another that needs more mines
+        { 4, 2, 2, "####1221", EXACT, 2, 2 },           // Both ends are inside the middle numbers
+        { 4, 2, 1, "####1110", EXACT, 3, 1 },
+        { 2, 1, 1, "#2", CONTRADICTION, -1, -1 },       // More than the closed tiles around it
+        { 3, 2, 3, "###131", CONTRADICTION, -1, -1 },   // The 3 needs a mine the 1 beside it can't have
+        { 3, 2, 0, "###111", CONTRADICTION, -1, -1 },   // More mines than the board has
+    };
+
+    Board board;
+    Solver solver;
+    Probability probability;
+    std::vector<uint8_t> output;
+    int failed = 0;
+
+    auto get = [&](size_t offset) { uint32_t value; memcpy(&value, &output[offset], 4); return static_cast<int>(value); };
+
+    for (const check_t &check : checks)
+    {
+        position_t position;
+        position.width = check.width;
+        position.height = check.height;
+        position.mines = check.mines;
+        position.cells = check.cells;
+        position.parsed = true;
+
+        output.clear();
+        Analyze(position, board, solver, probability, output);
+
+        int safe = get(16), mined = get(20);
+        bool passed = output[4] == check.status && (check.status != EXACT || (safe == check.safe && mined == check.mined));
+        failed += !passed;
+
+        printf("%s %dx%d %s: status %d, %d safe, %d mines, expected %d", passed ? "ok  " : "FAIL", check.width, check.height, check.cells,
+               output[4], safe, mined, check.status);
+
+        if (check.status == EXACT)
+            printf(", %d and %d", check.safe, check.mined);
+
+        printf("\n");
+    }
+
+    // Positions with a row too few, a row too many and a line too long, each followed by one that is fine
+    std::string input = "2 2 1\n#1\n\n2 2 1\n#1\n11\n\n"
+                        "2 2 1\n#1\n11\n11\n\n2 2 1\n#1\n11\n\n"
+                        "2 2 1\n" + std::string(10000, '#') + "\n11\n\n2 2 1\n#1\n11\n";
+    static const bool parsed[] = { false, true, false, true, false, true };
+
+    FILE *file = tmpfile();
+
+    if (!file)
+    {
+        printf("FAIL couldn't create a temporary file\n");
+        return 1;
+    }
+
+    fwrite(input.data(), 1, input.size(), file);
+    rewind(file);
+
+    position_t position;
+    uint32_t number = 0;
+    size_t count = 0;
+    bool passed = true;
+
+    for (; ReadPosition(file, position, number); count++)
+        passed = passed && count < std::size(parsed) && position.parsed == parsed[count];
+
+    passed = passed && count == std::size(parsed);
+    failed += !passed;
+    fclose(file);
+
+    printf("%s %zu positions read with broken rows, expected %zu\n", passed ? "ok  " : "FAIL", count, std::size(parsed));
+
+    return failed ? 1 : 0;
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    const char *input = argc > 1 ? argv[1] : nullptr;
+    const char *output = argc > 2 ? argv[2] : nullptr;
+    int threadCount = argc > 3 ? atoi(argv[3]) : 0;
+
+    if (input && !strcmp(input, "--check"))
+        return Check();
+
+    if (!input || !output)
+    {
+        printf("Usage: MinefieldAnalyze <input, - for stdin> <output> [threads]\n");
+        printf("       MinefieldAnalyze --check\n");
+        return 1;
+    }
+
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    FILE *in = strcmp(input, "-") ? fopen(input, "r") : stdin;
+
+    if (!in)
+    {
+        printf("Couldn't open %s\n", input);
+        return 1;
+    }
+
+    FILE *out = fopen(output, "wb");
+
+    if (!out)
+    {
+        printf("Couldn't create %s\n", output);
+        return 1;
+    }
+
+    std::vector<uint8_t> header(ANALYZE_MAGIC, ANALYZE_MAGIC + 4);
+    Put(header, ANALYZE_VERSION, 4);
+    Put(header, ANALYZE_RECORD_BYTES, 4);
+    fwrite(header.data(), 1, header.size(), out);
+
+    pipeline_t pipeline;
+    pipeline.maxInFlight = threadCount * ANALYZE_BATCHES_PER_THREAD;
+    totals_t totals;
+    bool writeFailed = false;
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]()
+    {
+        Board board;
+        Solver solver;
+        Probability probability;
+
+        for (;;)
+        {
+            std::unique_ptr<batch_t> batch;
+
+            {
+                std::unique_lock<std::mutex> lock(pipeline.mutex);
+                pipeline.changed.wait(lock, [&]() { return !pipeline.queued.empty() || pipeline.finished; });
+
+                if (pipeline.queued.empty())
+                    return;
+
+                batch = std::move(pipeline.queued.front());
+                pipeline.queued.pop_front();
+            }
+
+            batch->output.clear();
+            batch->output.reserve(batch->positions.size() * ANALYZE_RECORD_BYTES);
+
+            for (const position_t &position : batch->positions)
+                Analyze(position, board, solver, probability, batch->output);
+
+            std::lock_guard<std::mutex> lock(pipeline.mutex);
+            pipeline.done[batch->index] = std::move(batch);
+            pipeline.changed.notify_all();
+        }
+    };
+
+    // Writes finished batches in input order
+    auto writer = [&]()
+    {
+        for (uint64_t next = 0;; next++)
+        {
+            std::unique_ptr<batch_t> batch;
+
+            {
+                std::unique_lock<std::mutex> lock(pipeline.mutex);
+                pipeline.changed.wait(lock, [&]() { return pipeline.done.count(next) || (pipeline.finished && !pipeline.inFlight); });
+
+                if (!pipeline.done.count(next))
+                    return;
+
+                batch = std::move(pipeline.done[next]);
+                pipeline.done.erase(next);
+            }
+
+            if (fwrite(batch->output.data(), 1, batch->output.size(), out) != batch->output.size())
+                writeFailed = true;
+
+            for (size_t i = 0; i < batch->positions.size(); i++)
+            {
+                const uint8_t *record = &batch->output[i * ANALYZE_RECORD_BYTES];
+                uint32_t safe, mined;
+                memcpy(&safe, record + 16, 4);
+                memcpy(&mined, record + 20, 4);
+
+                totals.positions++;
+                totals.statuses[record[4]]++;
+                totals.safe += safe;
+                totals.mined += mined;
+            }
+
+            std::lock_guard<std::mutex> lock(pipeline.mutex);
+            pipeline.inFlight--;
+            pipeline.changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < threadCount; i++)
+        threads.emplace_back(worker);
+
+    std::thread writing(writer);
+    uint32_t lineNumber = 0;
+    bool more = true;
+
+    for (uint64_t index = 0; more; index++)
+    {
+        auto batch = std::make_unique<batch_t>();
+        batch->index = index;
+        batch->positions.resize(ANALYZE_BATCH);
+
+        size_t count = 0;
+
+        while (count < batch->positions.size() && (more = ReadPosition(in, batch->positions[count], lineNumber)))
+            count++;
+
+        batch->positions.resize(count);
+
+        if (!count)
+            break;
+
+        std::unique_lock<std::mutex> lock(pipeline.mutex);
+        pipeline.changed.wait(lock, [&]() { return pipeline.inFlight < pipeline.maxInFlight; });
+        pipeline.inFlight++;
+        pipeline.queued.push_back(std::move(batch));
+        pipeline.changed.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        pipeline.finished = true;
+        pipeline.changed.notify_all();
+    }
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    writing.join();
+
+    if (in != stdin)
+        fclose(in);
+
+    if (fclose(out) != 0 || writeFailed)
+    {
+        printf("Couldn't write %s\n", output);
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%llu positions in %.2f s, %.0f positions/s on %d threads\n", static_cast<unsigned long long>(totals.positions), seconds,
+           totals.positions / std::max(seconds, 1e-9), threadCount);
+    printf("%llu exact, %llu too big, %llu contradictions, %llu parse errors\n",
+           static_cast<unsigned long long>(totals.statuses[EXACT]), static_cast<unsigned long long>(totals.statuses[TOO_BIG]),
+           static_cast<unsigned long long>(totals.statuses[CONTRADICTION]), static_cast<unsigned long long>(totals.statuses[PARSE_ERROR]));
+    printf("%.2f safe and %.2f mined tiles proven per position\n", totals.positions ? static_cast<double>(totals.safe) / totals.positions : 0.0,
+           totals.positions ? static_cast<double>(totals.mined) / totals.positions : 0.0);
+
+    return 0;
+}
@@ -0,0 +1,553 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Fits the model behind the Auto difficulty to games played by bots, then plays simulated
+// players of every skill against it and against the old heuristic.
+// Usage: MinefieldAutoDifficulty [players] [games per player] [bot games per field] [threads]
+//
+// A simulated player plays like the probability bot, except for a chance to blunder on
+// every move, and takes its own time per move and longer for guesses. Both vary from
+// player to player, so the fitted model never matches any of them exactly.
+
+#include "../AutoDifficulty.h"
+#include "../Bot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#define BOT_MAX_NODES               20000   // The bot only needs to guess well, not perfectly
+#define GUESS_WEIGHT                5.0f    // A guess takes as long as this many moves
+#define DURATION_NOISE              0.3f    // Standard deviation of the log of a game's duration
+#define MIN_BLUNDER                 0.0003f // Chance to lose on any move
+#define MAX_BLUNDER                 0.02f
+#define MIN_SECONDS_PER_MOVE        0.5f
+#define MAX_SECONDS_PER_MOVE        4.0f
+#define HEURISTIC_ATTEMPTS          3       // The heuristic the model replaces
+#define HEURISTIC_RATIO_CHANGE      0.005f
+#define HEURISTIC_WIN_RATE          0.25f   // Where one step up per win and one down per three losses settle
+#define CONVERGED_ERROR             0.1f    // A player has converged once their chance to win stays this close to the target
+#define CONVERGED_GAMES             10
+
+static const int fieldHeights[] = { 10, 13, 16, 20, 24, 28, 32, 35 };
+static const int ratioCount = 9;
+
+struct cell_t
+{
+    int                 width = 0;
+    int                 height = 0;
+    float               ratio = 0.0f;
+    int                 games = 0;
+    int                 wins = 0;
+    double              moves = 0.0;
+    double              guesses = 0.0;
+    double              openedTiles = 0.0;
+
+    float               WinRate() const { return games ? static_cast<float>(wins) / games : 0.0f; }
+    float               MovesPerTile() const { return openedTiles > 0.0 ? static_cast<float>(moves / openedTiles) : 1.0f; }
+    float               GuessesPerTile() const { return openedTiles > 0.0 ? static_cast<float>(guesses / openedTiles) : 0.0f; }
+};
+
+struct player_t
+{
+    float               blunder = 0.0f;
+    float               secondsPerMove = 0.0f;
+};
+
+// What a simulated player really gets on a field
+struct truth_t
+{
+    float               winProbability = 0.0f;
+    float               seconds = 0.0f;     // Of a won game
+};
+
+struct summary_t
+{
+    std::vector<int>    convergedAfter;
+    double              winRateError = 0.0;
+    double              durationError = 0.0;
+    double              ratioChange = 0.0;
+    double              sizeChange = 0.0;
+    double              wins = 0.0;
+    double              lateGames = 0.0;
+    double              games = 0.0;
+};
+
+static std::vector<cell_t> cells;
+
+/*
+===================
+FieldWidth
+
+The Auto difficulty keeps the proportions of its default field.
+===================
+*/
+static int FieldWidth(int height)
+{
+    int width = static_cast<int>(std::lround(static_cast<float>(height) * DEFAULT_AUTO_FIELD_WIDTH / DEFAULT_AUTO_FIELD_HEIGHT));
+    return std::clamp(width, MINIMAL_FIELD_WIDTH, MAXIMAL_FIELD_WIDTH);
+}
+
+/*
+===================
+Ratio
+===================
+*/
+static float Ratio(int index)
+{
+    return MINIMAL_MINE_RATIO + (MAXIMAL_MINE_RATIO - MINIMAL_MINE_RATIO) * index / (ratioCount - 1);
+}
+
+/*
+===================
+PlayCell
+===================
+*/
+static void PlayCell(cell_t &cell, int games, uint64_t seed)
+{
+    SolverBot bot(SolverBot::PROBABILITY, seed);
+    Random random(seed, 1);
+    Board board;
+    bot.maxNodes = BOT_MAX_NODES;
+
+    for (int game = 0; game < games; game++)
+    {
+        board.Reset(cell.width, cell.height, static_cast<int>(cell.width * cell.height * cell.ratio));
+        bot.Reset(board);
+
+        int guesses = static_cast<int>(bot.Stats().guesses);
+        Bot::move_t move;
+        int moves = 0;
+
+        while (board.State() == Board::PLAYING && moves < board.Size() * 4 && bot.NextMove(board, move))
+        {
+            if (move.action == Bot::OPEN && !board.IsGenerated())
+                board.GenerateMines(move.x, move.y, random);
+
+            if (move.action == Bot::OPEN)
+                board.Open(move.x, move.y);
+            else if (move.action == Bot::CHORD)
+                board.Chord(move.x, move.y);
+            else
+                board.ToggleFlag(move.x, move.y, false);
+
+            moves++;
+        }
+
+        cell.games++;
+        cell.wins += board.State() == Board::WON;
+        cell.moves += moves;
+        cell.guesses += static_cast<int>(bot.Stats().guesses) - guesses;
+        cell.openedTiles += board.Size() - board.Mines() - board.ClosedSafeTiles();
+    }
+}
+
+/*
+===================
+Lerp
+===================
+*/
+static float Lerp(float a, float b, float t)
+{
+    return a + (b - a) * t;
+}
+
+/*
+===================
+Truth
+
+Interpolates the bots' results over the log of the field size and the mine ratio.
+===================
+*/
+static truth_t Truth(const player_t &player, int width, int height, float ratio)
+{
+    int heights = static_cast<int>(std::size(fieldHeights));
+    float size = std::log(static_cast<float>(width * height));
+    float ratioIndex = std::clamp((ratio - MINIMAL_MINE_RATIO) / (MAXIMAL_MINE_RATIO - MINIMAL_MINE_RATIO) * (ratioCount - 1), 0.0f, ratioCount - 1.0f);
+    int r = std::min(static_cast<int>(ratioIndex), ratioCount - 2);
+    float rt = ratioIndex - r;
+    int h = 0;
+
+    while (h < heights - 2 && std::log(static_cast<float>(cells[(h + 1) * ratioCount].width * cells[(h + 1) * ratioCount].height)) < size)
+        h++;
+
+    float low = std::log(static_cast<float>(cells[h * ratioCount].width * cells[h * ratioCount].height));
+    float high = std::log(static_cast<float>(cells[(h + 1) * ratioCount].width * cells[(h + 1) * ratioCount].height));
+    float ht = std::clamp((size - low) / (high - low), 0.0f, 1.0f);
+
+    auto at = [&](auto field)
+    {
+        float a = Lerp(field(cells[h * ratioCount + r]), field(cells[h * ratioCount + r + 1]), rt);
+        float b = Lerp(field(cells[(h + 1) * ratioCount + r]), field(cells[(h + 1) * ratioCount + r + 1]), rt);
+        return Lerp(a, b, ht);
+    };
+
+    float safeTiles = width * height * (1.0f - ratio);
+    float moves = at([](const cell_t &cell) { return cell.MovesPerTile(); }) * safeTiles;
+    float guesses = at([](const cell_t &cell) { return cell.GuessesPerTile(); }) * safeTiles;
+
+    truth_t truth;
+    truth.winProbability = at([](const cell_t &cell) { return cell.WinRate(); }) * std::pow(1.0f - player.blunder, moves);
+    truth.seconds = player.secondsPerMove * (moves + GUESS_WEIGHT * guesses);
+
+    return truth;
+}
+
+/*
+===================
+Solve
+
+Gaussian elimination for the small normal equations of the fits.
+===================
+*/
+static void Solve(double matrix[3][4], int n, double *result)
+{
+    for (int i = 0; i < n; i++)
+    {
+        int pivot = i;
+
+        for (int j = i + 1; j < n; j++)
+            if (std::abs(matrix[j][i]) > std::abs(matrix[pivot][i]))
+                pivot = j;
+
+        for (int k = 0; k <= n; k++)
+            std::swap(matrix[i][k], matrix[pivot][k]);
+
+        for (int j = 0; j < n; j++)
+        {
+            if (j == i || matrix[i][i] == 0.0)
+                continue;
+
+            double factor = matrix[j][i] / matrix[i][i];
+
+            for (int k = i; k <= n; k++)
+                matrix[j][k] -= factor * matrix[i][k];
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+        result[i] = matrix[i][i] != 0.0 ? matrix[i][n] / matrix[i][i] : 0.0;
+}
+
+/*
+===================
+RandomPlayer
+===================
+*/
+static player_t RandomPlayer(Random &random)
+{
+    player_t player;
+    player.blunder = MIN_BLUNDER * std::pow(MAX_BLUNDER / MIN_BLUNDER, random.Float());
+    player.secondsPerMove = MIN_SECONDS_PER_MOVE * std::pow(MAX_SECONDS_PER_MOVE / MIN_SECONDS_PER_MOVE, random.Float());
+
+    return player;
+}
+
+/*
+===================
+Gaussian
+===================
+*/
+static float Gaussian(Random &random)
+{
+    float u = std::max(random.Float(), 1e-7f);
+    return std::sqrt(-2.0f * std::log(u)) * std::cos(6.2831853f * random.Float());
+}
+
+/*
+===================
+Simulate
+
+Plays one player against a controller, which takes the last game and the field to change.
+===================
+*/
+template<typename controller_t>
+static void Simulate(const player_t &player, int games, float target, uint64_t seed, controller_t &&controller, summary_t &summary)
+{
+    Random random(seed, 0);
+    int width = DEFAULT_AUTO_FIELD_WIDTH, height = DEFAULT_AUTO_FIELD_HEIGHT;
+    float ratio = DEFAULT_MINE_RATIO;
+    std::vector<float> errors;
+    int lastHeight = height;
+    float lastRatio = ratio;
+
+    for (int game = 0; game < games; game++)
+    {
+        int mines = static_cast<int>(width * height * ratio);
+        float actualRatio = static_cast<float>(mines) / (width * height);
+        truth_t truth = Truth(player, width, height, actualRatio);
+
+        AutoDifficulty::game_t played;
+        played.width = width;
+        played.height = height;
+        played.mines = mines;
+        played.won = random.Float() < truth.winProbability;
+
+        float part = played.won ? 1.0f : random.Float();
+        played.seconds = truth.seconds * part * std::exp(DURATION_NOISE * Gaussian(random));
+        played.openedTiles = static_cast<int>((width * height - mines) * part);
+
+        errors.push_back(std::abs(truth.winProbability - target));
+        summary.games++;
+        summary.wins += played.won;
+
+        if (game >= games / 2)
+        {
+            summary.winRateError += std::abs(truth.winProbability - target);
+            summary.durationError += std::abs(std::log(truth.seconds / PREFERRED_GAME_DURATION));
+            summary.ratioChange += std::abs(ratio - lastRatio);
+            summary.sizeChange += std::abs(height - lastHeight);
+            summary.lateGames++;
+        }
+
+        lastHeight = height;
+        lastRatio = ratio;
+        controller(played, width, height, ratio);
+    }
+
+    int converged = games;
+
+    for (int game = games - CONVERGED_GAMES; game >= 0; game--)
+    {
+        bool stays = true;
+
+        for (int k = game; k < game + CONVERGED_GAMES && stays; k++)
+            stays = errors[k] <= CONVERGED_ERROR;
+
+        if (!stays)
+            break;
+
+        converged = game;
+    }
+
+    summary.convergedAfter.push_back(converged);
+}
+
+/*
+===================
+Print
+===================
+*/
+static void Print(const char *name, float target, int games, summary_t &summary)
+{
+    std::vector<int> &converged = summary.convergedAfter;
+    std::sort(converged.begin(), converged.end());
+
+    int never = static_cast<int>(std::count(converged.begin(), converged.end(), games));
+    auto percentile = [&](float p) { return converged[std::min(converged.size() - 1, static_cast<size_t>(p * converged.size()))]; };
+
+    printf("%-10s %7.0f%% %8.1f%% %8.1f%% %9.3f %9.4f %9.3f %9d %9d %9.1f%%\n", name, target * 100.0f, 100.0 * summary.wins / summary.games,
+           100.0 * summary.winRateError / summary.lateGames, summary.durationError / summary.lateGames,
+           summary.ratioChange / summary.lateGames, summary.sizeChange / summary.lateGames, percentile(0.5f), percentile(0.9f),
+           100.0 * never / converged.size());
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    int players = argc > 1 ? atoi(argv[1]) : 2000;
+    int games = argc > 2 ? atoi(argv[2]) : 100;
+    int cellGames = argc > 3 ? atoi(argv[3]) : 100;
+    int threadCount = argc > 4 ? atoi(argv[4]) : 0;
+
+    if (players <= 0 || games <= CONVERGED_GAMES || cellGames <= 0)
+    {
+        printf("Usage: MinefieldAutoDifficulty [players] [games per player, more than %d] [bot games per field] [threads]\n", CONVERGED_GAMES);
+        return 1;
+    }
+
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    // Bots on every field
+    for (int height : fieldHeights)
+    {
+        for (int r = 0; r < ratioCount; r++)
+        {
+            cell_t cell;
+            cell.width = FieldWidth(height);
+            cell.height = height;
+            cell.ratio = Ratio(r);
+            cells.push_back(cell);
+        }
+    }
+
+    std::atomic<int> next = 0;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int c = next++; c < static_cast<int>(cells.size()); c = next++)
+                PlayCell(cells[c], cellGames, c + 1);
+        });
+    }
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    printf("Bot win rates, %d games per field\n\n%-8s", cellGames, "Field");
+
+    for (int r = 0; r < ratioCount; r++)
+        printf("%7.3f", Ratio(r));
+
+    printf("\n");
+
+    for (size_t h = 0; h < std::size(fieldHeights); h++)
+    {
+        printf("%3dx%-4d", cells[h * ratioCount].width, cells[h * ratioCount].height);
+
+        for (int r = 0; r < ratioCount; r++)
+            printf("%6.0f%%", cells[h * ratioCount + r].WinRate() * 100.0f);
+
+        printf("\n");
+    }
+
+    // Time per tile of a player who takes a second per move, by least squares over the mine ratio
+    double time[3][4] = {};
+
+    for (const cell_t &cell : cells)
+    {
+        double x[2] = { 1.0, cell.ratio - DEFAULT_MINE_RATIO };
+        double t = std::log(cell.MovesPerTile() + GUESS_WEIGHT * cell.GuessesPerTile());
+
+        for (int i = 0; i < 2; i++)
+        {
+            for (int j = 0; j < 2; j++)
+                time[i][j] += x[i] * x[j];
+
+            time[i][2] += x[i] * t;
+        }
+    }
+
+    // Win chances of a population of players, since blunders make big fields harder than they are for bots.
+    // Weighted least squares on how much each player's log-odds drop from the default field.
+    Random random(0, 0);
+    double win[3][4] = {};
+    double skill = 0.0, skillSquares = 0.0, speed = 0.0, speedSquares = 0.0;
+    const int population = 10000;
+
+    auto logOdds = [](float p)
+    {
+        p = std::clamp(p, 0.001f, 0.999f);
+        return std::log(p / (1.0f - p));
+    };
+
+    for (int i = 0; i < population; i++)
+    {
+        player_t player = RandomPlayer(random);
+        truth_t truth = Truth(player, DEFAULT_AUTO_FIELD_WIDTH, DEFAULT_AUTO_FIELD_HEIGHT, DEFAULT_MINE_RATIO);
+        double s = logOdds(truth.winProbability);
+        double v = std::log(truth.seconds / (DEFAULT_AUTO_FIELD_WIDTH * DEFAULT_AUTO_FIELD_HEIGHT * (1.0f - DEFAULT_MINE_RATIO)));
+
+        skill += s;
+        skillSquares += s * s;
+        speed += v;
+        speedSquares += v * v;
+
+        for (const cell_t &cell : cells)
+        {
+            float p = Truth(player, cell.width, cell.height, cell.ratio).winProbability;
+            double weight = std::max(p * (1.0f - p), 0.001f);
+            double y = s - logOdds(p);
+            double x[2] = { cell.ratio - DEFAULT_MINE_RATIO,
+                            std::log(static_cast<double>(cell.width * cell.height) / (DEFAULT_AUTO_FIELD_WIDTH * DEFAULT_AUTO_FIELD_HEIGHT)) };
+
+            for (int a = 0; a < 2; a++)
+            {
+                for (int b = 0; b < 2; b++)
+                    win[a][b] += weight * x[a] * x[b];
+
+                win[a][2] += weight * x[a] * y;
+            }
+        }
+    }
+
+    double winFit[2], timeFit[2];
+    Solve(win, 2, winFit);
+    Solve(time, 2, timeFit);
+
+    skill /= population;
+    speed /= population;
+
+    printf("\n%-24s %10s %10s\n", "Model", "fitted", "compiled");
+    printf("%-24s %10.3f %10.3f\n", "AUTO_RATIO_SLOPE", winFit[0], AUTO_RATIO_SLOPE);
+    printf("%-24s %10.3f %10.3f\n", "AUTO_SIZE_SLOPE", winFit[1], AUTO_SIZE_SLOPE);
+    printf("%-24s %10.3f %10.3f\n", "AUTO_TIME_RATIO_SLOPE", timeFit[1], AUTO_TIME_RATIO_SLOPE);
+    printf("%-24s %10.3f %10.3f\n", "AUTO_SKILL_PRIOR", skill, AUTO_SKILL_PRIOR);
+    printf("%-24s %10.3f %10.3f\n", "AUTO_SKILL_VARIANCE", skillSquares / population - skill * skill, AUTO_SKILL_VARIANCE);
+    printf("%-24s %10.3f %10.3f\n", "AUTO_SPEED_PRIOR", speed, AUTO_SPEED_PRIOR);
+    printf("%-24s %10.3f %10.3f\n", "AUTO_SPEED_VARIANCE", speedSquares / population - speed * speed, AUTO_SPEED_VARIANCE);
+    printf("%-24s %10.3f %10.3f\n", "AUTO_SPEED_NOISE", DURATION_NOISE * DURATION_NOISE, AUTO_SPEED_NOISE);
+
+    // Simulated players against both controllers, with the compiled model
+    summary_t heuristic, model;
+    Random playerRandom(1, 0);
+
+    for (int p = 0; p < players; p++)
+    {
+        player_t player = RandomPlayer(playerRandom);
+        int attempts = 0;
+
+        Simulate(player, games, HEURISTIC_WIN_RATE, p, [&](const AutoDifficulty::game_t &game, int &width, int &height, float &ratio)
+        {
+            if (!game.won && ++attempts >= HEURISTIC_ATTEMPTS)
+            {
+                attempts = 0;
+                ratio -= HEURISTIC_RATIO_CHANGE;
+            }
+            else if (game.won)
+            {
+                attempts = 0;
+                ratio += HEURISTIC_RATIO_CHANGE;
+                width += game.seconds < PREFERRED_GAME_DURATION ? 1 : -1;
+                height += game.seconds < PREFERRED_GAME_DURATION ? 1 : -1;
+            }
+
+            ratio = std::clamp(ratio, MINIMAL_MINE_RATIO, MAXIMAL_MINE_RATIO);
+            width = std::clamp(width, MINIMAL_FIELD_WIDTH, MAXIMAL_FIELD_WIDTH);
+            height = std::clamp(height, MINIMAL_FIELD_HEIGHT, MAXIMAL_FIELD_HEIGHT);
+        }, heuristic);
+
+        AutoDifficulty controller;
+
+        Simulate(player, games, AUTO_TARGET_WIN_RATE, p, [&](const AutoDifficulty::game_t &game, int &width, int &height, float &ratio)
+        {
+            controller.Record(game);
+            controller.Next(width, height, ratio);
+        }, model);
+    }
+
+    printf("\n%d players, %d games each. Errors and changes are per game over the second half.\n", players, games);
+    printf("Convergence is the games played until the chance to win stays within %.0f%% of the target for %d games.\n\n", CONVERGED_ERROR * 100.0f, CONVERGED_GAMES);
+    printf("%-10s %8s %9s %9s %9s %9s %9s %9s %9s %10s\n", "", "target", "won", "win err", "time err", "ratio chg", "rows chg", "conv p50", "conv p90", "never");
+    Print("Heuristic", HEURISTIC_WIN_RATE, games, heuristic);
+    Print("Model", AUTO_TARGET_WIN_RATE, games, model);
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// A bot that only uses the C interface of BotLink, to measure how fast moves get through.
+// It opens random closed tiles in batches and starts over whenever a game ends.
+// Usage: MinefieldBotClient [name] [seconds] [batch]
+
+#include "../BotLink.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    const char *name = argc > 1 ? argv[1] : MF_DEFAULT_NAME;
+    int seconds = argc > 2 ? atoi(argv[2]) : 5;
+    int batch = argc > 3 ? atoi(argv[3]) : 256;
+
+    mf_link_t *link = mf_connect(name);
+
+    if (!link)
+    {
+        printf("No host is running on \"%s\"\n", name);
+        return 1;
+    }
+
+    const mf_shared_t *view = mf_view(link);
+    std::vector<mf_command_t> commands;
+    std::vector<uint32_t> closed;
+    uint64_t submitted = 0, reads = 0, retries = 0, games = 0;
+    uint32_t random = 12345;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(seconds);
+
+    while (std::chrono::steady_clock::now() < end)
+    {
+        uint32_t sequence, width, height, state;
+
+        // Reads the board in place, and again if the host was publishing meanwhile
+        for (;;)
+        {
+            sequence = mf_read_begin(link);
+            width = view->width;
+            height = view->height;
+            state = view->state;
+            closed.clear();
+
+            for (uint32_t y = 0; y < height; y++)
+                for (uint32_t x = 0; x < width; x++)
+                    if (mf_tile(view, x, y) == MF_TILE_CLOSED)
+                        closed.push_back(y << 16 | x);
+
+            reads++;
+
+            if (mf_read_end(link, sequence))
+                break;
+
+            retries++;
+        }
+
+        commands.clear();
+
+        if (state != MF_PLAYING || closed.empty())
+        {
+            commands.push_back({ MF_RESTART, 0, 0, 0, 0 });
+            games++;
+        }
+        else
+        {
+            // Distinct random tiles, the game is lost after the first mine anyway
+            for (int i = 0; i < batch && !closed.empty(); i++)
+            {
+                random = random * 1664525u + 1013904223u;
+                size_t pick = (random >> 8) % closed.size();
+                uint32_t tile = closed[pick];
+
+                commands.push_back({ MF_OPEN, 0, static_cast<uint16_t>(tile & 0xFFFF), static_cast<uint16_t>(tile >> 16), 0 });
+                closed[pick] = closed.back();
+                closed.pop_back();
+            }
+        }
+
+        for (size_t sent = 0; sent < commands.size();)
+            sent += mf_submit(link, commands.data() + sent, static_cast<uint32_t>(commands.size() - sent));
+
+        submitted += commands.size();
+
+        if (!mf_wait(link, 1000))
+        {
+            printf("The host stopped answering\n");
+            break;
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%.0f commands/s, %.0f reads/s, %.0f games/s, %llu reads retried\n", submitted / elapsed, reads / elapsed, games / elapsed,
+           static_cast<unsigned long long>(retries));
+
+    mf_disconnect(link);
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Runs the rules without a window and lets a bot play through BotLink.
+// Usage: MinefieldBotHost [difficulty] [name] [seconds, 0 for no limit] [seed]
+
+#include "../BotHost.h"
+#include "../Random.h"
+#include "Difficulty.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    const difficulty_t *difficulty = FindDifficulty(argc > 1 ? argv[1] : "expert");
+    const char *name = argc > 2 ? argv[2] : MF_DEFAULT_NAME;
+    int seconds = argc > 3 ? atoi(argv[3]) : 0;
+    uint64_t seed = argc > 4 ? strtoull(argv[4], nullptr, 10) : static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    if (!difficulty)
+    {
+        printf("Usage: MinefieldBotHost [beginner|intermediate|expert] [name] [seconds] [seed]\n");
+        return 1;
+    }
+
+    BotHost host;
+
+    if (!host.Open(name))
+    {
+        printf("Couldn't create the shared memory \"%s\": %s\n", name, host.Error());
+        return 1;
+    }
+
+    Board board;
+    Random random(seed, 0);
+    board.Reset(difficulty->width, difficulty->height, difficulty->mines);
+    host.Publish(board);
+
+    printf("%s on \"%s\", seed %llu\n", difficulty->name, name, static_cast<unsigned long long>(seed));
+
+    uint64_t commands = 0, games = 0, wins = 0;
+    uint64_t lastCommands = 0, lastGames = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto report = start + std::chrono::seconds(1);
+
+    auto handler = [&](const mf_command_t &command)
+    {
+        if (command.action == MF_RESTART)
+        {
+            games++;
+            wins += board.State() == Board::WON;
+            board.Reset(difficulty->width, difficulty->height, difficulty->mines);
+            return;
+        }
+
+        if (!board.IsInside(command.x, command.y))
+            return;
+
+        if (command.action == MF_OPEN)
+        {
+            if (!board.IsGenerated())
+                board.GenerateMines(command.x, command.y, random);
+
+            board.Open(command.x, command.y);
+        }
+        else if (command.action == MF_CHORD)
+        {
+            board.Chord(command.x, command.y);
+        }
+        else if (command.action == MF_FLAG)
+        {
+            board.ToggleFlag(command.x, command.y, false);
+        }
+    };
+
+    for (;;)
+    {
+        int polled = host.Poll(board, handler);
+        commands += polled;
+
+        // Nothing to do, the bot gets the core
+        if (!polled)
+            std::this_thread::yield();
+
+        auto now = std::chrono::steady_clock::now();
+
+        if (now < report)
+            continue;
+
+        printf("%llu commands/s, %llu games/s, %llu games, %.1f%% won\n",
+               static_cast<unsigned long long>(commands - lastCommands), static_cast<unsigned long long>(games - lastGames),
+               static_cast<unsigned long long>(games), games ? 100.0 * wins / games : 0.0);
+        fflush(stdout);
+
+        lastCommands = commands;
+        lastGames = games;
+        report += std::chrono::seconds(1);
+
+        if (seconds && now - start >= std::chrono::seconds(seconds))
+            break;
+    }
+
+    return 0;
+}
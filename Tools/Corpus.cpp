@@ -0,0 +1,138 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Generates a corpus of boards with their metrics for training and evaluating bots.
+// Usage: MinefieldCorpus <output> [boards] [beginner|intermediate|expert] [threads] [nocheck]
+
+#include "../Corpus.h"
+#include "../Generator.h"
+#include "../Random.h"
+#include "Difficulty.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    const char *output = argc > 1 ? argv[1] : nullptr;
+    long long boards = argc > 2 ? atoll(argv[2]) : 1000000;
+    const difficulty_t *difficulty = FindDifficulty(argc > 3 ? argv[3] : "expert");
+    int threadCount = argc > 4 ? atoi(argv[4]) : 0;
+    bool check = !(argc > 5 && !strcmp(argv[5], "nocheck"));
+
+    if (!output || boards <= 0 || !difficulty)
+    {
+        printf("Usage: MinefieldCorpus <output> [boards] [beginner|intermediate|expert] [threads] [nocheck]\n");
+        return 1;
+    }
+
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    CorpusWriter writer;
+
+    if (!writer.Create(output, difficulty->width, difficulty->height, difficulty->mines))
+    {
+        fprintf(stderr, "Couldn't create '%s'.\n", output);
+        return 1;
+    }
+
+    int tiles = difficulty->width * difficulty->height;
+    uint32_t chunks = static_cast<uint32_t>((boards + CORPUS_CHUNK_BOARDS - 1) / CORPUS_CHUNK_BOARDS);
+    std::atomic<uint32_t> next = 0;
+    std::atomic<long long> noGuess = 0;
+    std::atomic<bool> failed = false;
+
+    // Every thread fills whole chunks, so memory use doesn't depend on the number of boards
+    auto worker = [&]()
+    {
+        std::vector<uint8_t> data(Corpus::ChunkBytes(tiles, CORPUS_CHUNK_BOARDS));
+        Board board;
+        Metrics metrics;
+        Solver solver;
+        long long solvable = 0;
+
+        for (uint32_t chunk = next++; chunk < chunks && !failed; chunk = next++)
+        {
+            // Each chunk has its own random stream, so the corpus doesn't depend on the number of threads
+            Random random(difficulty->mines, chunk);
+            int count = static_cast<int>(std::min<long long>(CORPUS_CHUNK_BOARDS, boards - static_cast<long long>(chunk) * CORPUS_CHUNK_BOARDS));
+            std::fill(data.begin(), data.end(), 0);
+
+            for (int slot = 0; slot < count; slot++)
+            {
+                int click = random.Int(0, tiles - 1);
+
+                board.Reset(difficulty->width, difficulty->height, difficulty->mines);
+                board.GenerateMines(board.X(click), board.Y(click), random);
+                metrics.Compute(board);
+
+                // Solving only opens and flags tiles, the mines and the numbers stay as they are
+                bool solved = check && Generator::IsSolvable(board, solver, board.X(click), board.Y(click));
+                solvable += solved;
+
+                Corpus::Pack(data.data(), slot, board, click, metrics, solved);
+            }
+
+            if (!writer.Write(chunk, data.data(), count))
+                failed = true;
+        }
+
+        noGuess += solvable;
+    };
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+
+    for (int i = 0; i < threadCount; i++)
+        pool.emplace_back(worker);
+
+    for (std::thread &thread : pool)
+        thread.join();
+
+    if (failed || !writer.Finish())
+    {
+        fprintf(stderr, "Couldn't write '%s'.\n", output);
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    int lastBoards = static_cast<int>(boards - static_cast<long long>(chunks - 1) * CORPUS_CHUNK_BOARDS);
+    size_t bytes = Corpus::ChunkBytes(tiles, CORPUS_CHUNK_BOARDS) * (chunks - 1) + Corpus::ChunkBytes(tiles, lastBoards);
+
+    printf("Wrote %lld %s boards to '%s' in %.2f s on %d threads.\n", boards, difficulty->name, output, seconds, threadCount);
+    printf("%.0f boards/s, %.1fM boards/min, about %.1f bytes per board.\n", boards / seconds, boards / seconds * 60.0 / 1e6,
+           static_cast<double>(bytes) / boards);
+
+    if (check)
+        printf("%.2f%% can be solved without guessing.\n", 100.0 * noGuess / boards);
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+
+// The fixed difficulty levels of the game, for the tools that measure things per level
+struct difficulty_t
+{
+    const char *        name;
+    int                 width;
+    int                 height;
+    int                 mines;
+};
+
+static const difficulty_t difficulties[] =
+{
+    { "Beginner", 10, 10, 10 },
+    { "Intermediate", 16, 16, 40 },
+    { "Expert", 30, 16, 99 }
+};
+
+/*
+===================
+FindDifficulty
+
+Case-insensitive, returns nullptr for unknown names.
+===================
+*/
+inline const difficulty_t *FindDifficulty(const char *name)
+{
+    for (const difficulty_t &difficulty : difficulties)
+    {
+        size_t i = 0;
+
+        while (name[i] && difficulty.name[i] && (name[i] | 0x20) == (difficulty.name[i] | 0x20))
+            i++;
+
+        if (!name[i] && !difficulty.name[i])
+            return &difficulty;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,132 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Prints the statistics of a game history, optionally after appending made-up games to it.
+// Usage: MinefieldHistory <file> [games to append]
+
+#include "../History.h"
+#include "../Random.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+static const char *difficultyNames[HISTORY_DIFFICULTIES] = { "Beginner", "Intermediate", "Expert", "Auto", "Custom" };
+
+/*
+===================
+Milliseconds
+===================
+*/
+static double Milliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : nullptr;
+    long long append = argc > 2 ? atoll(argv[2]) : 0;
+
+    if (!path || append < 0)
+    {
+        printf("Usage: MinefieldHistory <file> [games to append]\n");
+        return 1;
+    }
+
+    History history;
+
+    if (append)
+    {
+        if (!history.Open(path))
+        {
+            printf("Couldn't open %s\n", path);
+            return 1;
+        }
+
+        Random random(static_cast<uint64_t>(time(nullptr)), 0);
+        double slowest = 0.0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (long long i = 0; i < append; i++)
+        {
+            History::game_t game;
+            game.difficulty = static_cast<uint8_t>(random.Int(0, HISTORY_DIFFICULTIES - 1));
+            game.won = random.Float() < 0.4f;
+            game.milliseconds = static_cast<uint32_t>(1000.0 * std::exp(random.Float() * 6.0f));
+            game.date = time(nullptr);
+            game.seed = random.Next();
+
+            auto call = std::chrono::steady_clock::now();
+            history.Append(game);
+            slowest = std::max(slowest, Milliseconds(call));
+        }
+
+        double appending = Milliseconds(start);
+        history.Close();
+
+        printf("Appended %lld games in %.1f ms, %.3f ms at most per call, %.1f ms until written\n", append, appending, slowest, Milliseconds(start));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (!history.Open(path))
+    {
+        printf("Couldn't open %s\n", path);
+        return 1;
+    }
+
+    double opening = Milliseconds(start);
+    History::stats_t stats[HISTORY_DIFFICULTIES];
+
+    start = std::chrono::steady_clock::now();
+
+    for (int d = 0; d < HISTORY_DIFFICULTIES; d++)
+    {
+        stats[d] = history.Stats(d);
+        stats[d].PercentileSeconds(50.0f);
+        stats[d].PercentileSeconds(90.0f);
+    }
+
+    double querying = Milliseconds(start);
+
+    printf("%llu games, opened in %.2f ms, queried in %.3f ms", static_cast<unsigned long long>(history.Games()), opening, querying);
+
+    if (history.RecoveredBytes())
+        printf(", %llu bytes of torn blocks cut off", static_cast<unsigned long long>(history.RecoveredBytes()));
+
+    printf("\n\n%-14s %10s %8s %10s %10s %10s %10s\n", "Difficulty", "games", "won", "best s", "mean s", "p50 s", "p90 s");
+
+    for (int d = 0; d < HISTORY_DIFFICULTIES; d++)
+    {
+        const History::stats_t &s = stats[d];
+
+        printf("%-14s %10llu %7.1f%% %10.3f %10.2f %10.2f %10.2f\n", difficultyNames[d], static_cast<unsigned long long>(s.games),
+               s.WinRate() * 100.0f, s.best / 1000.0f, s.MeanSeconds(), s.PercentileSeconds(50.0f), s.PercentileSeconds(90.0f));
+    }
+
+    return 0;
+}
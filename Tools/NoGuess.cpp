@@ -0,0 +1,91 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Measures how long no-guess boards take to generate on every difficulty.
+// Usage: MinefieldNoGuess [boards per difficulty] [threads]
+
+#include "../Generator.h"
+#include "../Random.h"
+#include "Difficulty.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/*
+===================
+Percentile
+===================
+*/
+static double Percentile(const std::vector<double> &sorted, double percentile)
+{
+    size_t index = static_cast<size_t>(percentile / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    int boards = argc > 1 ? atoi(argv[1]) : 200;
+    Generator generator;
+    generator.threads = argc > 2 ? atoi(argv[2]) : 0;
+    generator.seed = 1;
+
+    if (boards <= 0)
+    {
+        printf("Usage: MinefieldNoGuess [boards per difficulty] [threads]\n");
+        return 1;
+    }
+
+    Random random(2);
+
+    printf("%-14s %8s %8s %8s %8s %8s %10s\n", "Difficulty", "p50 ms", "p90 ms", "p99 ms", "max ms", "failed", "attempts");
+
+    for (const difficulty_t &difficulty : difficulties)
+    {
+        std::vector<double> latencies;
+        int failed = 0;
+        long long attempts = 0;
+
+        for (int i = 0; i < boards; i++)
+        {
+            Board board;
+            board.Reset(difficulty.width, difficulty.height, difficulty.mines);
+
+            if (!generator.Generate(board, random.Int(0, difficulty.width - 1), random.Int(0, difficulty.height - 1)))
+                failed++;
+
+            latencies.push_back(generator.Stats().milliseconds);
+            attempts += generator.Stats().attempts;
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+
+        printf("%-14s %8.2f %8.2f %8.2f %8.2f %8d %10.1f\n", difficulty.name, Percentile(latencies, 50.0), Percentile(latencies, 90.0),
+               Percentile(latencies, 99.0), latencies.back(), failed, static_cast<double>(attempts) / boards);
+        fflush(stdout);
+    }
+
+    return 0;
+}
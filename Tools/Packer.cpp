@@ -0,0 +1,204 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Builds Data.mpk from Minefield/Data with every texture already decoded, sounds are loaded by the engine from the files.
+// Usage: MinefieldPacker [data directory] [output file]
+
+#include "../Pack.h"
+#include "TGA.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct packFile_t
+{
+    std::string         name;
+    Pack::entry_t       entry = {};
+    std::vector<uint8_t> data;
+};
+
+/*
+===================
+DecodeTexture
+
+Textures are stored as top-down RGBA8 pixels.
+===================
+*/
+static bool DecodeTexture(const std::vector<uint8_t> &tga, packFile_t &file)
+{
+    image_t image;
+
+    if (!DecodeTGA(tga, image))
+        return false;
+
+    file.data = std::move(image.pixels);
+    file.entry.type = Pack::TEXTURE;
+    file.entry.width = image.width;
+    file.entry.height = image.height;
+    file.entry.format = 32;
+
+    return true;
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    fs::path dataDir = argc > 1 ? argv[1] : "Data";
+    fs::path output = argc > 2 ? argv[2] : "Data.mpk";
+
+    if (!fs::is_directory(dataDir))
+    {
+        fprintf(stderr, "Couldn't find the data directory '%s'.\n", dataDir.string().c_str());
+        return 1;
+    }
+
+    std::vector<packFile_t> files;
+
+    for (const fs::directory_entry &it : fs::recursive_directory_iterator(dataDir))
+    {
+        if (!it.is_regular_file())
+            continue;
+
+        packFile_t file;
+        file.name = fs::relative(it.path(), dataDir).generic_string();
+
+        std::vector<uint8_t> source;
+
+        if (!ReadFile(it.path(), source))
+        {
+            fprintf(stderr, "Couldn't read '%s'.\n", file.name.c_str());
+            return 1;
+        }
+
+        std::string extension = it.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+        bool decoded = false;
+
+        if (extension == ".tga")
+            decoded = DecodeTexture(source, file);
+
+        // Anything else, or anything we couldn't decode, is stored as is
+        if (!decoded)
+        {
+            file.entry = {};
+            file.entry.type = Pack::RAW;
+            file.data = std::move(source);
+        }
+
+        file.entry.hash = Pack::Hash(file.name.c_str());
+        file.entry.size = file.data.size();
+        files.push_back(std::move(file));
+    }
+
+    std::sort(files.begin(), files.end(), [](const packFile_t &a, const packFile_t &b) { return a.entry.hash < b.entry.hash; });
+
+    for (size_t i = 1; i < files.size(); i++)
+    {
+        if (files[i].entry.hash == files[i - 1].entry.hash)
+        {
+            fprintf(stderr, "Name hash collision between '%s' and '%s'.\n", files[i].name.c_str(), files[i - 1].name.c_str());
+            return 1;
+        }
+    }
+
+    // Names follow the entry table, data starts at the next aligned offset
+    uint64_t offset = sizeof(Pack::header_t) + files.size() * sizeof(Pack::entry_t);
+
+    for (packFile_t &file : files)
+    {
+        file.entry.name = static_cast<uint32_t>(offset);
+        offset += file.name.size() + 1;
+    }
+
+    for (packFile_t &file : files)
+    {
+        offset = (offset + PACK_ALIGNMENT - 1) & ~static_cast<uint64_t>(PACK_ALIGNMENT - 1);
+        file.entry.offset = offset;
+        offset += file.data.size();
+    }
+
+    std::ofstream out(output, std::ios::binary);
+
+    if (!out)
+    {
+        fprintf(stderr, "Couldn't create '%s'.\n", output.string().c_str());
+        return 1;
+    }
+
+    Pack::header_t header = { PACK_MAGIC, PACK_VERSION, static_cast<uint32_t>(files.size()), 0 };
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    for (const packFile_t &file : files)
+        out.write(reinterpret_cast<const char *>(&file.entry), sizeof(file.entry));
+
+    for (const packFile_t &file : files)
+        out.write(file.name.c_str(), file.name.size() + 1);
+
+    for (const packFile_t &file : files)
+    {
+        static const char zeros[PACK_ALIGNMENT] = {};
+        out.write(zeros, file.entry.offset - static_cast<uint64_t>(out.tellp()));
+        out.write(reinterpret_cast<const char *>(file.data.data()), file.data.size());
+    }
+
+    if (!out)
+    {
+        fprintf(stderr, "Couldn't write '%s'.\n", output.string().c_str());
+        return 1;
+    }
+
+    out.close();
+
+    // Reads the pack back the way it's mapped, so a broken pack is caught here
+    Pack pack;
+
+    if (!pack.Open(output.string().c_str()))
+    {
+        fprintf(stderr, "Couldn't open '%s' after writing it.\n", output.string().c_str());
+        return 1;
+    }
+
+    for (const packFile_t &file : files)
+    {
+        const Pack::entry_t *entry = pack.Find(file.name.c_str());
+
+        if (!entry || entry->type != file.entry.type || entry->size != file.data.size() ||
+            (!file.data.empty() && memcmp(pack.Data(*entry), file.data.data(), file.data.size())))
+        {
+            fprintf(stderr, "'%s' doesn't match in '%s'.\n", file.name.c_str(), output.string().c_str());
+            return 1;
+        }
+    }
+
+    printf("Packed %zu files into '%s' (%llu bytes).\n", files.size(), output.string().c_str(), static_cast<unsigned long long>(offset));
+
+    return 0;
+}
@@ -0,0 +1,550 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Checks that replays are games that were really played, and how fast it's done.
+// Usage: MinefieldReplay [--moves] <replays or directories...>
+//        MinefieldReplay --bench [replays] [threads]
+//        MinefieldReplay --seek [width] [height]
+//        MinefieldReplay --undo [width] [height]
+
+#include "../Replay.h"
+#include "../Generator.h"
+#include "../Bot.h"
+#include "../MoveHistory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const char *typeNames[] = { "open", "flag", "question", "clear", "chord", "restart" };
+static const char *resultNames[] = { "won", "lost", "abandoned" };
+
+/*
+===================
+Verify
+
+Plays every replay on as many threads, returns the time it took in seconds.
+===================
+*/
+static double Verify(const std::vector<Replay> &replays, std::vector<ReplayPlayer::error_t> &errors, int threadCount)
+{
+    std::atomic<size_t> next = 0;
+    std::vector<std::thread> threads;
+    errors.assign(replays.size(), ReplayPlayer::NONE);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&]()
+        {
+            Board board;
+            ReplayPlayer player;
+
+            for (size_t i = next++; i < replays.size(); i = next++)
+            {
+                player.Start(replays[i], board);
+                errors[i] = player.Finish(board);
+            }
+        });
+    }
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*
+===================
+PrintMoves
+
+The state of the board after every action.
+===================
+*/
+static void PrintMoves(const Replay &replay)
+{
+    Board board;
+    ReplayPlayer player;
+    player.Start(replay, board);
+
+    printf("%6s %9s %-9s %4s %4s %7s %6s %s\n", "action", "ms", "type", "x", "y", "closed", "mines", "state");
+
+    while (player.Step(board))
+    {
+        const Replay::action_t &action = player.Action();
+        const char *state = board.State() == Board::WON ? "won" : board.State() == Board::LOST ? "lost" : "playing";
+
+        printf("%6u %9u %-9s %4d %4d %7d %6d %s\n", player.Applied(), action.milliseconds, typeNames[action.type],
+               action.x, action.y, board.ClosedSafeTiles(), board.ShownMinesLeft(), state);
+    }
+}
+
+/*
+===================
+Record
+
+Expert games played by a bot with human delays between actions, the way the game records them.
+===================
+*/
+static void Record(std::vector<Replay> &replays, int count)
+{
+    Random random(1, 0);
+
+    for (int game = 0; game < count; game++)
+    {
+        Replay replay;
+        replay.header.width = 30;
+        replay.header.height = 16;
+        replay.header.mines = 99;
+        replay.header.difficulty = 2;
+
+        Board board;
+        board.Reset(30, 16, 99);
+
+        SolverBot bot(SolverBot::PROBABILITY, game);
+        bot.flagMines = true;
+        bot.Reset(board);
+
+        uint64_t seed = (random.Next() >> 24) | 1;
+        uint32_t milliseconds = 0;
+        Bot::move_t move;
+
+        while (board.State() == Board::PLAYING && bot.NextMove(board, move))
+        {
+            Replay::type_t type = Replay::OPEN;
+
+            if (move.action == Bot::CHORD)
+                type = Replay::CHORD;
+            else if (move.action == Bot::FLAG)
+                type = Replay::MarkType(board.At(move.x, move.y).state, false);
+
+            if (move.action == Bot::OPEN && !board.IsGenerated())
+            {
+                Generator::FromSeed(board, seed, move.x, move.y);
+                replay.header.seed = seed;
+            }
+
+            replay.Append({ milliseconds, type, move.x, move.y });
+
+            if (move.action == Bot::OPEN)
+                board.Open(move.x, move.y);
+            else if (move.action == Bot::CHORD)
+                board.Chord(move.x, move.y);
+            else
+                board.ToggleFlag(move.x, move.y, false);
+
+            milliseconds += 150 + random.Int(0, 700);
+        }
+
+        if (board.State() == Board::PLAYING)
+            replay.Append({ milliseconds, Replay::RESTART, 0, 0 });
+
+        replay.header.result = board.State() == Board::WON ? Replay::WON : board.State() == Board::LOST ? Replay::LOST : Replay::ABANDONED;
+        replays.push_back(replay);
+    }
+}
+
+/*
+===================
+Bench
+===================
+*/
+static int Bench(int count, int threadCount)
+{
+    std::vector<Replay> replays;
+    Record(replays, count);
+
+    size_t bytes = 0, actions = 0;
+
+    for (const Replay &replay : replays)
+    {
+        bytes += sizeof(Replay::header_t) + replay.stream.size();
+        actions += replay.header.actions;
+    }
+
+    std::vector<ReplayPlayer::error_t> errors;
+    double seconds = Verify(replays, errors, threadCount);
+    int valid = static_cast<int>(std::count(errors.begin(), errors.end(), ReplayPlayer::NONE));
+
+    printf("%d Expert replays, %.1f actions and %.0f bytes on average\n", count, static_cast<double>(actions) / count, static_cast<double>(bytes) / count);
+    printf("%d valid, verified in %.1f ms on %d threads, %.0f replays/s\n", valid, seconds * 1000.0, threadCount, count / seconds);
+
+    // A replay that claims a better game than was played
+    int caught = 0;
+
+    for (Replay &replay : replays)
+    {
+        if (replay.header.result == Replay::WON)
+            replay.header.milliseconds -= 1;
+        else
+            replay.header.result = Replay::WON;
+    }
+
+    Verify(replays, errors, threadCount);
+
+    for (ReplayPlayer::error_t error : errors)
+        caught += error != ReplayPlayer::NONE;
+
+    printf("%d of %d tampered replays rejected\n", caught, count);
+    return valid == count && caught == count ? 0 : 1;
+}
+
+/*
+===================
+RecordLong
+
+A long game on a big board, played block by block like a person sweeping the field. Mines are flagged
+or left alone, every safe tile still closed is opened.
+===================
+*/
+static void RecordLong(Replay &replay, int width, int height)
+{
+    Random random(2, 0);
+    Board board;
+    board.Reset(width, height, width * height * 16 / 100);
+
+    uint64_t seed = (random.Next() >> 24) | 1;
+    int x = Generator::SeedX(board), y = Generator::SeedY(board);
+    Generator::FromSeed(board, seed, x, y);
+
+    replay.Clear();
+    replay.header.width = width;
+    replay.header.height = height;
+    replay.header.mines = board.Mines();
+    replay.header.seed = seed;
+
+    uint32_t milliseconds = 0;
+    replay.Append({ milliseconds, Replay::OPEN, x, y });
+    board.Open(x, y);
+
+    const int block = 16;
+    std::vector<int> blocks;
+
+    for (int b = 0; b < ((width + block - 1) / block) * ((height + block - 1) / block); b++)
+        blocks.push_back(b);
+
+    for (size_t i = blocks.size() - 1; i > 0; i--)
+        std::swap(blocks[i], blocks[random.Int(0, static_cast<int>(i))]);
+
+    int blocksWide = (width + block - 1) / block;
+
+    for (int b : blocks)
+    {
+        for (int j = (b / blocksWide) * block; j < std::min(height, (b / blocksWide + 1) * block); j++)
+        {
+            for (int i = (b % blocksWide) * block; i < std::min(width, (b % blocksWide + 1) * block); i++)
+            {
+                const Tile &tile = board.At(i, j);
+
+                if (board.State() != Board::PLAYING || tile.state != Tile::CLOSED)
+                    continue;
+
+                milliseconds += 100 + random.Int(0, 500);
+
+                if (tile.type != Tile::MINED)
+                {
+                    replay.Append({ milliseconds, Replay::OPEN, i, j });
+                    board.Open(i, j);
+                }
+                else if (random.Int(0, 1))
+                {
+                    replay.Append({ milliseconds, Replay::FLAG, i, j });
+                    board.ToggleFlag(i, j, false);
+                }
+            }
+        }
+    }
+
+    replay.header.result = board.State() == Board::WON ? Replay::WON : Replay::ABANDONED;
+
+    if (board.State() == Board::PLAYING)
+        replay.Append({ milliseconds, Replay::RESTART, 0, 0 });
+}
+
+/*
+===================
+SeekBench
+===================
+*/
+static int SeekBench(int width, int height)
+{
+    Replay replay;
+    RecordLong(replay, width, height);
+
+    auto start = std::chrono::steady_clock::now();
+    replay.BuildKeyframes();
+    double building = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%dx%d board, %u actions in %u bytes, %zu keyframes in %u bytes, taken in %.0f ms\n", width, height, replay.header.actions,
+           replay.header.streamBytes, replay.Keyframes().size(), replay.header.keyframeBytes, building);
+
+    Board board, reference;
+    ReplayPlayer player, linear;
+
+    start = std::chrono::steady_clock::now();
+    linear.Start(replay, reference);
+    ReplayPlayer::error_t error = linear.Finish(reference);
+    double playing = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Played from the start to the end in %.1f ms, %s\n", playing, ReplayPlayer::ErrorName(error));
+
+    // Scrubbing back and forth, the first positions are checked against playing there from the start
+    Random random(3, 0);
+    double total = 0.0, slowest = 0.0;
+    int seeks = 40, wrong = 0;
+
+    // The first action generates the board, which happens once when a replay is opened
+    player.Start(replay, board);
+    player.Step(board);
+
+    for (int s = 0; s < seeks; s++)
+    {
+        uint32_t target = static_cast<uint32_t>(random.Int(0, static_cast<int>(replay.header.milliseconds)));
+
+        start = std::chrono::steady_clock::now();
+        player.Seek(board, target);
+        double seeking = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        total += seeking;
+        slowest = std::max(slowest, seeking);
+
+        if (s < 8)
+        {
+            linear.Start(replay, reference);
+
+            while (linear.NextMilliseconds() <= target && linear.Step(reference));
+
+            for (int i = 0; i < board.Size(); i++)
+                if (board[i].state != reference[i].state)
+                    wrong++;
+
+            if (board.ShownMinesLeft() != reference.ShownMinesLeft() || board.ClosedSafeTiles() != reference.ClosedSafeTiles() ||
+                player.leftClicks != linear.leftClicks || player.rightClicks != linear.rightClicks || player.Applied() != linear.Applied())
+                wrong++;
+        }
+    }
+
+    printf("%d seeks, %.2f ms on average, %.2f ms at most, %d differences from playing from the start\n", seeks, total / seeks, slowest, wrong);
+    return wrong ? 1 : 0;
+}
+
+/*
+===================
+UndoBench
+
+Plays a long game into a move history, undoes it back to the first move and redoes it to the end again.
+===================
+*/
+static int UndoBench(int width, int height)
+{
+    Replay replay;
+    RecordLong(replay, width, height);
+
+    Board board;
+    ReplayPlayer player;
+    MoveHistory history;
+
+    // Positions to check on the way back, as they were when played
+    Random random(4, 0);
+    std::vector<size_t> checked;
+    std::vector<std::vector<Tile::state_t>> expected;
+    std::vector<Board::counters_t> expectedCounters;
+
+    player.Start(replay, board);
+
+    auto start = std::chrono::steady_clock::now();
+
+    while (!player.IsDone())
+    {
+        player.Step(board);
+        history.Commit(board);
+
+        if (history.Positions() > 1 && !random.Int(0, 2047))
+        {
+            checked.push_back(history.Current());
+            expected.emplace_back();
+            expectedCounters.push_back(board.Counters());
+
+            for (int i = 0; i < board.Size(); i++)
+                expected.back().push_back(board[i].state);
+        }
+    }
+
+    double committing = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<Tile::state_t> end;
+
+    for (int i = 0; i < board.Size(); i++)
+        end.push_back(board[i].state);
+
+    size_t moves = history.Positions() - 1, changed = 0;
+
+    for (size_t p = 1; p < history.Positions(); p++)
+        changed += history.ChangedTiles(p);
+
+    size_t bytes = history.Bytes();
+    printf("%dx%d board, %zu moves changing %zu tiles, committed in %.0f ms\n", width, height, moves, changed, committing);
+    printf("History takes %.1f MB, %.0f bytes a move, full copies would take %.0f MB\n", bytes / 1048576.0, static_cast<double>(bytes) / moves,
+           static_cast<double>(board.Size()) * history.Positions() / 1048576.0);
+
+    int wrong = 0;
+    std::vector<Tile::state_t> states;
+
+    // Read without touching the board first
+    for (size_t c = 0; c < checked.size(); c++)
+    {
+        history.States(checked[c], states);
+
+        if (states != expected[c])
+            wrong++;
+    }
+
+    double slowest = 0.0;
+    start = std::chrono::steady_clock::now();
+
+    while (history.CanUndo())
+    {
+        auto step = std::chrono::steady_clock::now();
+        history.Undo(board);
+        slowest = std::max(slowest, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - step).count());
+
+        for (size_t c = 0; c < checked.size(); c++)
+        {
+            if (checked[c] != history.Current())
+                continue;
+
+            for (int i = 0; i < board.Size(); i++)
+                if (board[i].state != expected[c][i])
+                    wrong++;
+
+            Board::counters_t counters = board.Counters();
+
+            if (counters.minesLeft != expectedCounters[c].minesLeft || counters.shownMinesLeft != expectedCounters[c].shownMinesLeft ||
+                counters.closedSafe != expectedCounters[c].closedSafe || counters.state != expectedCounters[c].state)
+                wrong++;
+        }
+    }
+
+    double undoing = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+
+    while (history.Redo(board));
+
+    double redoing = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for (int i = 0; i < board.Size(); i++)
+        if (board[i].state != end[i])
+            wrong++;
+
+    printf("Undone in %.0f ms, %.3f ms at most for a move, redone in %.0f ms\n", undoing, slowest, redoing);
+    printf("%zu positions checked, %d differences\n", checked.size() + 1, wrong);
+    return wrong ? 1 : 0;
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    int threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    if (argc > 1 && !strcmp(argv[1], "--bench"))
+        return Bench(argc > 2 ? std::max(1, atoi(argv[2])) : 1000, argc > 3 ? std::max(1, atoi(argv[3])) : threadCount);
+
+    if (argc > 1 && !strcmp(argv[1], "--seek"))
+        return SeekBench(argc > 2 ? std::max(16, atoi(argv[2])) : 1000, argc > 3 ? std::max(16, atoi(argv[3])) : 1000);
+
+    if (argc > 1 && !strcmp(argv[1], "--undo"))
+        return UndoBench(argc > 2 ? std::max(16, atoi(argv[2])) : 1000, argc > 3 ? std::max(16, atoi(argv[3])) : 1000);
+
+    bool moves = argc > 1 && !strcmp(argv[1], "--moves");
+    std::vector<std::string> paths;
+
+    for (int i = moves ? 2 : 1; i < argc; i++)
+    {
+        std::error_code error;
+
+        if (fs::is_directory(argv[i], error))
+        {
+            for (const fs::directory_entry &entry : fs::recursive_directory_iterator(argv[i], error))
+                if (entry.is_regular_file() && entry.path().extension() == ".mfr")
+                    paths.push_back(entry.path().string());
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (paths.empty())
+    {
+        printf("Usage: MinefieldReplay [--moves] <replays or directories...>\n");
+        printf("       MinefieldReplay --bench [replays] [threads]\n");
+        printf("       MinefieldReplay --seek [width] [height]\n");
+        printf("       MinefieldReplay --undo [width] [height]\n");
+        return 1;
+    }
+
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<Replay> replays(paths.size());
+
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        if (!replays[i].Load(paths[i].c_str()))
+        {
+            printf("%s: can't be read\n", paths[i].c_str());
+        }
+    }
+
+    std::vector<ReplayPlayer::error_t> errors;
+    double seconds = Verify(replays, errors, threadCount);
+    int valid = 0;
+
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        const Replay::header_t &header = replays[i].header;
+
+        if (!header.width)
+            continue;
+
+        printf("%s: %ux%u, %u mines, %s in %.3f s, %u actions, %s\n", paths[i].c_str(), header.width, header.height, header.mines,
+               resultNames[std::min<int>(header.result, Replay::ABANDONED)], header.milliseconds / 1000.0, header.actions, ReplayPlayer::ErrorName(errors[i]));
+
+        if (moves)
+            PrintMoves(replays[i]);
+
+        valid += errors[i] == ReplayPlayer::NONE;
+    }
+
+    printf("%d of %zu replays valid, verified in %.2f ms\n", valid, paths.size(), seconds * 1000.0);
+    return valid == static_cast<int>(paths.size()) ? 0 : 1;
+}
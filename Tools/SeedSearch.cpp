@@ -0,0 +1,245 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Finds board seeds with the requested properties, for events and challenges.
+// Usage: MinefieldSeedSearch <beginner|intermediate|expert> [3bv=min-max] [openings=min-max] [noguess]
+//                            [count=N] [from=seed] [limit=seeds] [threads=N]
+// Seeded boards start from the middle tile. Type in the code of one in the game with F7 to play it,
+// or set BoardSeed and BoardSeedHigh in the config with the same difficulty.
+// Only seeds a board code can hold are searched.
+
+#include "../BoardCode.h"
+#include "../Generator.h"
+#include "../Metrics.h"
+#include "Difficulty.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define SEARCH_BLOCK                1024    // Seeds a thread takes at once
+
+// Cheapest first, every stage only sees the candidates the previous ones let through
+enum stage_t
+{
+    STAGE_GENERATE,
+    STAGE_OPENINGS,
+    STAGE_THREE_BV,
+    STAGE_SOLVER,
+    STAGES
+};
+
+static const char *stageNames[STAGES] = { "generate", "openings", "3BV", "solver" };
+
+struct range_t
+{
+    int                 min = 0;
+    int                 max = INT_MAX;
+
+    bool                Contains(int value) const { return value >= min && value <= max; }
+};
+
+struct match_t
+{
+    uint64_t            seed;
+    int                 threeBV;
+    int                 openings;
+};
+
+/*
+===================
+ParseRange
+
+Accepts "min-max" or a single number.
+===================
+*/
+static bool ParseRange(const char *text, range_t &range)
+{
+    char *end = nullptr;
+    range.min = range.max = static_cast<int>(strtol(text, &end, 10));
+
+    if (end == text)
+        return false;
+
+    if (*end == '-')
+        range.max = static_cast<int>(strtol(end + 1, &end, 10));
+
+    return !*end && range.min <= range.max;
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    const difficulty_t *difficulty = argc > 1 ? FindDifficulty(argv[1]) : nullptr;
+    range_t threeBV, openings;
+    bool noGuess = false;
+    int count = 10;
+    uint64_t from = 1;
+    uint64_t limit = 100000000;
+    int threadCount = 0;
+    bool valid = difficulty != nullptr;
+
+    for (int i = 2; i < argc && valid; i++)
+    {
+        const char *arg = argv[i];
+
+        if (!strncmp(arg, "3bv=", 4))
+            valid = ParseRange(arg + 4, threeBV);
+        else if (!strncmp(arg, "openings=", 9))
+            valid = ParseRange(arg + 9, openings);
+        else if (!strcmp(arg, "noguess"))
+            noGuess = true;
+        else if (!strncmp(arg, "count=", 6))
+            count = atoi(arg + 6);
+        else if (!strncmp(arg, "from=", 5))
+            from = strtoull(arg + 5, nullptr, 10);
+        else if (!strncmp(arg, "limit=", 6))
+            limit = strtoull(arg + 6, nullptr, 10);
+        else if (!strncmp(arg, "threads=", 8))
+            threadCount = atoi(arg + 8);
+        else
+            valid = false;
+    }
+
+    if (!valid || count <= 0 || !from || from > BOARD_CODE_SEED_MASK)
+    {
+        printf("Usage: MinefieldSeedSearch <beginner|intermediate|expert> [3bv=min-max] [openings=min-max] [noguess]\n");
+        printf("                           [count=N] [from=seed] [limit=seeds] [threads=N]\n");
+        return 1;
+    }
+
+    // Seeds above the mask wouldn't survive a board code
+    limit = std::min<uint64_t>(limit, BOARD_CODE_SEED_MASK - from + 1);
+
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::atomic<uint64_t> next = 0;
+    std::atomic<int> found = 0;
+    std::atomic<uint64_t> entered[STAGES] = {}, passed[STAGES] = {};
+    std::mutex mutex;
+    std::vector<match_t> matches;
+
+    auto worker = [&]()
+    {
+        Board board;
+        Metrics metrics;
+        Solver solver;
+        uint64_t stageEntered[STAGES] = {}, stagePassed[STAGES] = {};
+
+        auto filter = [&](stage_t stage, bool pass)
+        {
+            stageEntered[stage]++;
+            stagePassed[stage] += pass;
+            return pass;
+        };
+
+        // Blocks are taken in order, so every seed below the last block taken gets checked
+        while (found < count)
+        {
+            uint64_t block = next.fetch_add(SEARCH_BLOCK);
+
+            if (block >= limit)
+                break;
+
+            for (uint64_t seed = from + block; seed < from + std::min(block + SEARCH_BLOCK, limit); seed++)
+            {
+                board.Reset(difficulty->width, difficulty->height, difficulty->mines);
+                Generator::FromSeed(board, seed);
+                filter(STAGE_GENERATE, true);
+
+                metrics.Compute(board);
+
+                if (!filter(STAGE_OPENINGS, openings.Contains(metrics.Openings())) ||
+                    !filter(STAGE_THREE_BV, threeBV.Contains(metrics.ThreeBV())))
+                    continue;
+
+                if (noGuess && !filter(STAGE_SOLVER, Generator::IsSolvable(board, solver, Generator::SeedX(board), Generator::SeedY(board))))
+                    continue;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                matches.push_back({ seed, metrics.ThreeBV(), metrics.Openings() });
+                found++;
+            }
+        }
+
+        for (int i = 0; i < STAGES; i++)
+        {
+            entered[i] += stageEntered[i];
+            passed[i] += stagePassed[i];
+        }
+    };
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+
+    for (int i = 0; i < threadCount; i++)
+        pool.emplace_back(worker);
+
+    for (std::thread &thread : pool)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    // Lowest seeds first, so the same query always gives the same seeds
+    std::sort(matches.begin(), matches.end(), [](const match_t &a, const match_t &b) { return a.seed < b.seed; });
+    matches.resize(std::min(matches.size(), static_cast<size_t>(count)));
+
+    printf("%s %dx%d, %d mines, starting from the middle tile\n\n", difficulty->name, difficulty->width, difficulty->height, difficulty->mines);
+
+    for (const match_t &match : matches)
+    {
+        BoardCode::code_t code;
+        code.width = difficulty->width;
+        code.height = difficulty->height;
+        code.mines = difficulty->mines;
+        code.x = difficulty->width / 2;
+        code.y = difficulty->height / 2;
+        code.seed = match.seed;
+
+        printf("Seed %llu (BoardSeed %d, BoardSeedHigh %d): 3BV %d, %d openings, code %s\n", static_cast<unsigned long long>(match.seed),
+               static_cast<int32_t>(static_cast<uint32_t>(match.seed)), static_cast<int>(match.seed >> 32), match.threeBV, match.openings,
+               BoardCode::Encode(code).c_str());
+    }
+
+    if (matches.empty())
+        printf("Nothing found.\n");
+
+    printf("\n%-10s %14s %14s %10s\n", "Stage", "candidates", "per second", "passed");
+
+    for (int i = 0; i < STAGES; i++)
+    {
+        if (entered[i])
+            printf("%-10s %14llu %14.0f %9.2f%%\n", stageNames[i], static_cast<unsigned long long>(entered[i].load()),
+                   entered[i] / seconds, 100.0 * passed[i] / entered[i]);
+    }
+
+    return 0;
+}
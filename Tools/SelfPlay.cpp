@@ -0,0 +1,205 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Plays complete games without a window to measure how well bots play and how fast the rules run.
+// Usage: MinefieldSelfPlay [games per difficulty] [threads] [random|probability|endgame]
+
+#include "../Bot.h"
+#include "Difficulty.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct results_t
+{
+    int                 games = 0;
+    int                 wins = 0;
+    uint64_t            moves = 0;
+    double              generateMilliseconds = 0.0;
+    double              applyMilliseconds = 0.0;
+    SolverBot::stats_t  bot;
+
+    void Add(const results_t &other)
+    {
+        games += other.games;
+        wins += other.wins;
+        moves += other.moves;
+        generateMilliseconds += other.generateMilliseconds;
+        applyMilliseconds += other.applyMilliseconds;
+        bot.deductions += other.bot.deductions;
+        bot.guesses += other.bot.guesses;
+        bot.deduceMilliseconds += other.bot.deduceMilliseconds;
+        bot.guessMilliseconds += other.bot.guessMilliseconds;
+    }
+};
+
+/*
+===================
+Milliseconds
+===================
+*/
+static double Milliseconds(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+/*
+===================
+Play
+
+Applies moves the same way the game does: mines are generated on the first opened tile,
+then tiles are opened, chorded and flagged with marks disabled.
+===================
+*/
+static void Play(const difficulty_t &difficulty, Bot &bot, Random &random, results_t &results)
+{
+    Board board;
+    board.Reset(difficulty.width, difficulty.height, difficulty.mines);
+    bot.Reset(board);
+
+    // Bots that never finish are given up on
+    int maxMoves = board.Size() * 4;
+    Bot::move_t move;
+
+    for (int moves = 0; moves < maxMoves && board.State() == Board::PLAYING; moves++)
+    {
+        if (!bot.NextMove(board, move))
+            break;
+
+        auto thought = std::chrono::steady_clock::now();
+
+        if (!board.IsInside(move.x, move.y))
+            break;
+
+        if (move.action == Bot::OPEN && !board.IsGenerated())
+        {
+            board.GenerateMines(move.x, move.y, random);
+            auto generated = std::chrono::steady_clock::now();
+            results.generateMilliseconds += Milliseconds(thought, generated);
+            thought = generated;
+        }
+
+        if (move.action == Bot::OPEN)
+            board.Open(move.x, move.y);
+        else if (move.action == Bot::CHORD)
+            board.Chord(move.x, move.y);
+        else
+            board.ToggleFlag(move.x, move.y, false);
+
+        results.applyMilliseconds += Milliseconds(thought, std::chrono::steady_clock::now());
+        results.moves++;
+    }
+
+    results.games++;
+    results.wins += board.State() == Board::WON;
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    int games = argc > 1 ? atoi(argv[1]) : 1000;
+    int threadCount = argc > 2 ? atoi(argv[2]) : 0;
+    const char *name = argc > 3 ? argv[3] : "probability";
+    SolverBot::guessing_t guessing;
+
+    if (!strcmp(name, "random"))
+        guessing = SolverBot::RANDOM;
+    else if (!strcmp(name, "probability"))
+        guessing = SolverBot::PROBABILITY;
+    else if (!strcmp(name, "endgame"))
+        guessing = SolverBot::ENDGAME;
+    else
+        games = 0;
+
+    if (games <= 0)
+    {
+        printf("Usage: MinefieldSelfPlay [games per difficulty] [threads] [random|probability|endgame]\n");
+        return 1;
+    }
+
+    if (threadCount <= 0)
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    printf("%d games per difficulty, %d threads, %s guessing\n\n", games, threadCount, name);
+    printf("%-14s %9s %9s %10s %11s %10s %10s %10s %10s\n", "Difficulty", "win rate", "+/-", "games/s", "moves/s",
+           "generate", "deduce", "guess", "apply");
+
+    for (const difficulty_t &difficulty : difficulties)
+    {
+        std::atomic<int> next = 0;
+        std::mutex mutex;
+        results_t total;
+
+        // Every game has its own random stream, so results don't depend on the number of threads
+        auto worker = [&]()
+        {
+            results_t results;
+
+            for (int game = next++; game < games; game = next++)
+            {
+                Random random(1, game);
+                SolverBot bot(guessing, game);
+                Play(difficulty, bot, random, results);
+                results.bot.deductions += bot.Stats().deductions;
+                results.bot.guesses += bot.Stats().guesses;
+                results.bot.deduceMilliseconds += bot.Stats().deduceMilliseconds;
+                results.bot.guessMilliseconds += bot.Stats().guessMilliseconds;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            total.Add(results);
+        };
+
+        auto started = std::chrono::steady_clock::now();
+        std::vector<std::thread> pool;
+
+        for (int i = 0; i < threadCount; i++)
+            pool.emplace_back(worker);
+
+        for (std::thread &thread : pool)
+            thread.join();
+
+        double seconds = Milliseconds(started, std::chrono::steady_clock::now()) / 1000.0;
+        double rate = static_cast<double>(total.wins) / total.games;
+
+        // Per game, in microseconds of thread time
+        double scale = 1000.0 / total.games;
+
+        printf("%-14s %8.2f%% %8.2f%% %10.1f %11.0f %8.1fus %8.1fus %8.1fus %8.1fus\n", difficulty.name,
+               rate * 100.0, 196.0 * std::sqrt(rate * (1.0 - rate) / total.games), total.games / seconds,
+               total.moves / seconds, total.generateMilliseconds * scale, total.bot.deduceMilliseconds * scale,
+               total.bot.guessMilliseconds * scale, total.applyMilliseconds * scale);
+        fflush(stdout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,348 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+// Packs numbered animation frames (Name0.tga, Name1.tga, ...) into one sprite sheet.
+// Transparent borders are trimmed, identical frames are stored once, and the frame
+// table is written as a header the game compiles in. Frames larger than they are ever
+// drawn can be downscaled by an integer factor.
+// Usage: MinefieldSpriteSheet <frames directory> <name> <output tga> <output header> <define prefix> [downscale]
+
+#include "TGA.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+#define SHEET_PADDING               1
+#define SHEET_MAX_SIZE              4096
+
+struct frame_t
+{
+    image_t             image;
+    int                 offsetX = 0;    // Trimmed rectangle inside the original frame
+    int                 offsetY = 0;
+    int                 width = 0;
+    int                 height = 0;
+    int                 sheetX = 0;
+    int                 sheetY = 0;
+    int                 same = -1;      // Index of an identical earlier frame
+};
+
+/*
+===================
+Downscale
+
+Box filter weighted by alpha, so transparent pixels don't darken the edges.
+===================
+*/
+static void Downscale(image_t &image, int factor)
+{
+    image_t scaled;
+    scaled.width = image.width / factor;
+    scaled.height = image.height / factor;
+    scaled.pixels.resize(static_cast<size_t>(scaled.width) * scaled.height * 4);
+
+    for (int y = 0; y < scaled.height; y++)
+    {
+        for (int x = 0; x < scaled.width; x++)
+        {
+            int color[3] = {}, alpha = 0;
+
+            for (int j = 0; j < factor; j++)
+            {
+                for (int i = 0; i < factor; i++)
+                {
+                    const uint8_t *p = image.At(x * factor + i, y * factor + j);
+
+                    for (int c = 0; c < 3; c++)
+                        color[c] += p[c] * p[3];
+
+                    alpha += p[3];
+                }
+            }
+
+            uint8_t *dst = scaled.At(x, y);
+
+            for (int c = 0; c < 3; c++)
+                dst[c] = alpha ? static_cast<uint8_t>(color[c] / alpha) : 0;
+
+            dst[3] = static_cast<uint8_t>(alpha / (factor * factor));
+        }
+    }
+
+    image = std::move(scaled);
+}
+
+/*
+===================
+Trim
+
+Finds the smallest rectangle that contains every visible pixel.
+===================
+*/
+static void Trim(frame_t &frame)
+{
+    const image_t &image = frame.image;
+    int minX = image.width, minY = image.height, maxX = -1, maxY = -1;
+
+    for (int y = 0; y < image.height; y++)
+    {
+        for (int x = 0; x < image.width; x++)
+        {
+            if (!image.At(x, y)[3])
+                continue;
+
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        }
+    }
+
+    // Fully transparent frames still take a single pixel
+    if (maxX < 0)
+    {
+        minX = minY = maxX = maxY = 0;
+    }
+
+    frame.offsetX = minX;
+    frame.offsetY = minY;
+    frame.width = maxX - minX + 1;
+    frame.height = maxY - minY + 1;
+}
+
+/*
+===================
+IsSame
+===================
+*/
+static bool IsSame(const frame_t &a, const frame_t &b)
+{
+    if (a.offsetX != b.offsetX || a.offsetY != b.offsetY || a.width != b.width || a.height != b.height)
+        return false;
+
+    for (int y = 0; y < a.height; y++)
+        if (memcmp(a.image.At(a.offsetX, a.offsetY + y), b.image.At(b.offsetX, b.offsetY + y), static_cast<size_t>(a.width) * 4))
+            return false;
+
+    return true;
+}
+
+/*
+===================
+Place
+
+Shelf packing into a sheet of the given width, frames are expected to be sorted by height.
+Returns the sheet height, which doesn't have to be a power of two.
+===================
+*/
+static int Place(std::vector<frame_t *> &frames, int sheetWidth)
+{
+    int x = 0, y = 0, shelf = 0;
+
+    for (frame_t *frame : frames)
+    {
+        if (frame->width + SHEET_PADDING > sheetWidth)
+            return SHEET_MAX_SIZE + 1;
+
+        if (x + frame->width + SHEET_PADDING > sheetWidth)
+        {
+            x = 0;
+            y += shelf;
+            shelf = 0;
+        }
+
+        frame->sheetX = x;
+        frame->sheetY = y;
+        x += frame->width + SHEET_PADDING;
+        shelf = std::max(shelf, frame->height + SHEET_PADDING);
+    }
+
+    return y + shelf;
+}
+
+/*
+===================
+main
+===================
+*/
+int main(int argc, char **argv)
+{
+    if (argc < 6)
+    {
+        printf("Usage: %s <frames directory> <name> <output tga> <output header> <define prefix> [downscale]\n", argv[0]);
+        return 1;
+    }
+
+    fs::path dir = argv[1];
+    std::string name = argv[2];
+    fs::path outImage = argv[3];
+    fs::path outHeader = argv[4];
+    std::string prefix = argv[5];
+    int downscale = argc > 6 ? std::max(1, atoi(argv[6])) : 1;
+    std::vector<frame_t> frames;
+    size_t before = 0;
+
+    for (int i = 0;; i++)
+    {
+        frame_t frame;
+
+        if (!LoadTGA(dir / (name + std::to_string(i) + ".tga"), frame.image))
+            break;
+
+        if (!frames.empty() && (frame.image.width != frames[0].image.width * downscale || frame.image.height != frames[0].image.height * downscale))
+        {
+            fprintf(stderr, "Frame %d has a different size.\n", i);
+            return 1;
+        }
+
+        if (frame.image.width % downscale || frame.image.height % downscale)
+        {
+            fprintf(stderr, "Frame %d can't be downscaled %d times.\n", i, downscale);
+            return 1;
+        }
+
+        before += frame.image.pixels.size();
+
+        if (downscale > 1)
+            Downscale(frame.image, downscale);
+
+        Trim(frame);
+        frames.push_back(std::move(frame));
+    }
+
+    if (frames.empty())
+    {
+        fprintf(stderr, "Couldn't find '%s0.tga' in '%s'.\n", name.c_str(), dir.string().c_str());
+        return 1;
+    }
+
+    std::vector<frame_t *> unique;
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        for (size_t j = 0; j < i && frames[i].same < 0; j++)
+            if (frames[j].same < 0 && IsSame(frames[i], frames[j]))
+                frames[i].same = static_cast<int>(j);
+
+        if (frames[i].same < 0)
+            unique.push_back(&frames[i]);
+    }
+
+    std::stable_sort(unique.begin(), unique.end(), [](const frame_t *a, const frame_t *b) { return a->height > b->height; });
+
+    // Picks the smallest sheet
+    int bestWidth = 0, bestHeight = 0;
+
+    for (int width = 64; width <= SHEET_MAX_SIZE; width += 64)
+    {
+        int height = Place(unique, width);
+
+        if (height > SHEET_MAX_SIZE)
+            continue;
+
+        long long area = static_cast<long long>(width) * height;
+        long long bestArea = static_cast<long long>(bestWidth) * bestHeight;
+
+        // Within a few percent of the smallest area, a squarer sheet wins
+        if (!bestWidth || area * 20 < bestArea * 19 || (area * 20 <= bestArea * 21 && std::max(width, height) < std::max(bestWidth, bestHeight)))
+        {
+            bestWidth = width;
+            bestHeight = height;
+        }
+    }
+
+    if (!bestWidth)
+    {
+        fprintf(stderr, "The frames don't fit into a %dx%d sheet.\n", SHEET_MAX_SIZE, SHEET_MAX_SIZE);
+        return 1;
+    }
+
+    Place(unique, bestWidth);
+
+    image_t sheet;
+    sheet.width = bestWidth;
+    sheet.height = bestHeight;
+    sheet.pixels.assign(static_cast<size_t>(bestWidth) * bestHeight * 4, 0);
+
+    for (const frame_t *frame : unique)
+        for (int y = 0; y < frame->height; y++)
+            memcpy(sheet.At(frame->sheetX, frame->sheetY + y), frame->image.At(frame->offsetX, frame->offsetY + y), static_cast<size_t>(frame->width) * 4);
+
+    if (!SaveTGA(outImage, sheet))
+    {
+        fprintf(stderr, "Couldn't write '%s'.\n", outImage.string().c_str());
+        return 1;
+    }
+
+    std::ofstream header(outHeader);
+
+    if (!header)
+    {
+        fprintf(stderr, "Couldn't write '%s'.\n", outHeader.string().c_str());
+        return 1;
+    }
+
+    auto define = [&header, &prefix](const char *key, int value)
+    {
+        std::string line = "#define " + prefix + "_" + key;
+        line.resize(std::max<size_t>(line.size() + 1, 36), ' ');
+        header << line << value << "\n";
+    };
+
+    std::string table = prefix;
+    std::transform(table.begin(), table.end(), table.begin(), ::tolower);
+    table += "SheetFrames";
+
+    header << "// Generated by MinefieldSpriteSheet from " << name << "*.tga, don't edit it by hand\n//";
+
+    for (int i = 1; i < argc; i++)
+        header << " " << argv[i];
+
+    header << "\n\n";
+    header << "#pragma once\n\n";
+    define("SHEET_WIDTH", sheet.width);
+    define("SHEET_HEIGHT", sheet.height);
+    define("FRAME_WIDTH", frames[0].image.width);
+    define("FRAME_HEIGHT", frames[0].image.height);
+    define("FRAMES", static_cast<int>(frames.size()));
+    header << "\n// Sheet x, y, width, height, then the offset of the trimmed rectangle inside the original frame\n";
+    header << "static const int " << table << "[" << prefix << "_FRAMES][6] =\n{\n";
+
+    for (const frame_t &frame : frames)
+    {
+        const frame_t &stored = frame.same < 0 ? frame : frames[frame.same];
+        header << "    { " << stored.sheetX << ", " << stored.sheetY << ", " << stored.width << ", " << stored.height << ", "
+               << stored.offsetX << ", " << stored.offsetY << " },\n";
+    }
+
+    header << "};\n";
+
+    printf("%zu frames (%zu unique) packed into a %dx%d sheet, %zu KB instead of %zu KB.\n", frames.size(), unique.size(),
+           sheet.width, sheet.height, sheet.pixels.size() / 1024, before / 1024);
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#include "TGA.h"
+
+#include <cstring>
+#include <fstream>
+
+/*
+===================
+ReadFile
+===================
+*/
+bool ReadFile(const std::filesystem::path &path, std::vector<uint8_t> &data)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+        return false;
+
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/*
+===================
+DecodeTGA
+
+Converts uncompressed or RLE true-color TGA images into top-down RGBA8 pixels.
+===================
+*/
+bool DecodeTGA(const std::vector<uint8_t> &tga, image_t &image)
+{
+    if (tga.size() < 18)
+        return false;
+
+    int idLength = tga[0];
+    int colorMapType = tga[1];
+    int imageType = tga[2];
+    int width = tga[12] | (tga[13] << 8);
+    int height = tga[14] | (tga[15] << 8);
+    int bpp = tga[16];
+    bool topDown = (tga[17] & 0x20) != 0;
+
+    if (colorMapType || (imageType != 2 && imageType != 10) || (bpp != 24 && bpp != 32) || !width || !height)
+        return false;
+
+    int bytes = bpp / 8;
+    size_t pixels = static_cast<size_t>(width) * height;
+    size_t pos = 18 + idLength;
+    std::vector<uint8_t> rgba(pixels * 4);
+
+    auto read = [&](size_t index) -> bool
+    {
+        if (pos + bytes > tga.size())
+            return false;
+
+        uint8_t *dst = &rgba[index * 4];
+        dst[0] = tga[pos + 2];
+        dst[1] = tga[pos + 1];
+        dst[2] = tga[pos + 0];
+        dst[3] = bytes == 4 ? tga[pos + 3] : 255;
+        pos += bytes;
+        return true;
+    };
+
+    if (imageType == 2)
+    {
+        for (size_t i = 0; i < pixels; i++)
+            if (!read(i))
+                return false;
+    }
+    else
+    {
+        for (size_t i = 0; i < pixels;)
+        {
+            if (pos >= tga.size())
+                return false;
+
+            int packet = tga[pos++];
+            size_t count = (packet & 0x7F) + 1;
+
+            if (i + count > pixels)
+                return false;
+
+            if (packet & 0x80)
+            {
+                if (!read(i))
+                    return false;
+
+                for (size_t j = 1; j < count; j++)
+                    memcpy(&rgba[(i + j) * 4], &rgba[i * 4], 4);
+            }
+            else
+            {
+                for (size_t j = 0; j < count; j++)
+                    if (!read(i + j))
+                        return false;
+            }
+
+            i += count;
+        }
+    }
+
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(rgba.size());
+    size_t row = static_cast<size_t>(width) * 4;
+
+    for (int y = 0; y < height; y++)
+    {
+        int srcY = topDown ? y : height - 1 - y;
+        memcpy(&image.pixels[y * row], &rgba[srcY * row], row);
+    }
+
+    return true;
+}
+
+/*
+===================
+LoadTGA
+===================
+*/
+bool LoadTGA(const std::filesystem::path &path, image_t &image)
+{
+    std::vector<uint8_t> data;
+    return ReadFile(path, data) && DecodeTGA(data, image);
+}
+
+/*
+===================
+SaveTGA
+
+Writes an uncompressed, bottom-up 32-bit TGA, the same layout as the game's textures.
+===================
+*/
+bool SaveTGA(const std::filesystem::path &path, const image_t &image)
+{
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file)
+        return false;
+
+    uint8_t header[18] = {};
+    header[2] = 2;
+    header[12] = static_cast<uint8_t>(image.width & 0xFF);
+    header[13] = static_cast<uint8_t>(image.width >> 8);
+    header[14] = static_cast<uint8_t>(image.height & 0xFF);
+    header[15] = static_cast<uint8_t>(image.height >> 8);
+    header[16] = 32;
+    header[17] = 8;
+
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+    std::vector<uint8_t> row(static_cast<size_t>(image.width) * 4);
+
+    for (int y = image.height - 1; y >= 0; y--)
+    {
+        for (int x = 0; x < image.width; x++)
+        {
+            const uint8_t *p = image.At(x, y);
+            row[x * 4 + 0] = p[2];
+            row[x * 4 + 1] = p[1];
+            row[x * 4 + 2] = p[0];
+            row[x * 4 + 3] = p[3];
+        }
+
+        file.write(reinterpret_cast<const char *>(row.data()), row.size());
+    }
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,40 @@
+/*
+===============================================================================
+    Copyright (C) 2023-2025 Ilya Lyakhovets
+
+    This program is free software : you can redistribute it and /or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see < http://www.gnu.org/licenses/>.
+===============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// Top-down RGBA8 image
+struct image_t
+{
+    int                 width = 0;
+    int                 height = 0;
+    std::vector<uint8_t> pixels;
+
+    uint8_t *           At(int x, int y) { return &pixels[(static_cast<size_t>(y) * width + x) * 4]; }
+    const uint8_t *     At(int x, int y) const { return &pixels[(static_cast<size_t>(y) * width + x) * 4]; }
+};
+
+bool                    ReadFile(const std::filesystem::path &path, std::vector<uint8_t> &data);
+bool                    DecodeTGA(const std::vector<uint8_t> &tga, image_t &image);
+bool                    LoadTGA(const std::filesystem::path &path, image_t &image);
+bool                    SaveTGA(const std::filesystem::path &path, const image_t &image);